@@ -0,0 +1,60 @@
+/**
+ * @file bench.h
+ * @brief Microbenchmarks of the network buffers.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NET_BENCH_H
+#define _O3D_NET_BENCH_H
+
+#include <o3d/core/base.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Measure the mean time of a functor over a number of iterations.
+ * @return Nanoseconds per iteration.
+ */
+template <class FUNCTOR>
+Double benchMeasure(UInt32 iterations, FUNCTOR functor)
+{
+    // warm up
+    functor();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (UInt32 i = 0; i < iterations; ++i)
+    {
+        functor();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<Double, std::nano>(end - start).count() / iterations;
+}
+
+//! Print a result line.
+inline void benchReport(const Char *name, Double ns, Double baseNs)
+{
+    std::cout << "  " << name << " : " << ns << " ns";
+
+    if (baseNs > 0.0)
+        std::cout << " (x" << (baseNs / ns) << ")";
+
+    std::cout << std::endl;
+}
+
+//! Typed-array read/write versus per-element calls.
+void benchArray();
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NET_BENCH_H
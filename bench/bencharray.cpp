@@ -0,0 +1,95 @@
+/**
+ * @file bencharray.cpp
+ * @brief Typed-array read/write versus per-element calls.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "bench.h"
+
+#include "o3d/net/netbuffer.h"
+
+#include <vector>
+
+using namespace o3d;
+using namespace o3d::net;
+
+namespace {
+
+const UInt32 ELEMENTS = 4096;
+const UInt32 ITERATIONS = 2000;
+
+void benchOrder(System::ByteOrder order, const Char *name)
+{
+    std::vector<Int32> values(ELEMENTS);
+    std::vector<Int32> result(ELEMENTS);
+
+    for (UInt32 i = 0; i < ELEMENTS; ++i)
+    {
+        values[i] = static_cast<Int32>(i * 2654435761u);
+    }
+
+    ArrayNetBuffer array(ELEMENTS * sizeof(Int64));
+    array.setByteOrder(order);
+
+    // virtual calls through the interface, as message classes do
+    NetBuffer *buffer = &array;
+
+    std::cout << name << " (" << ELEMENTS << " x Int32)" << std::endl;
+
+    const Double writeLoop = benchMeasure(ITERATIONS, [&] () {
+        buffer->setPosition(0);
+        buffer->setLimit(0);
+
+        for (UInt32 i = 0; i < ELEMENTS; ++i)
+        {
+            buffer->writeInt32(values[i]);
+        }
+    });
+
+    const Double writeArray = benchMeasure(ITERATIONS, [&] () {
+        buffer->setPosition(0);
+        buffer->setLimit(0);
+
+        buffer->writeInt32Array(values.data(), ELEMENTS);
+    });
+
+    const Double readLoop = benchMeasure(ITERATIONS, [&] () {
+        buffer->setPosition(0);
+
+        for (UInt32 i = 0; i < ELEMENTS; ++i)
+        {
+            result[i] = buffer->readInt32();
+        }
+    });
+
+    const Double readArray = benchMeasure(ITERATIONS, [&] () {
+        buffer->setPosition(0);
+
+        buffer->readInt32Array(result.data(), ELEMENTS);
+    });
+
+    if (result != values)
+    {
+        std::cout << "  mismatch after read" << std::endl;
+    }
+
+    benchReport("writeInt32 loop ", writeLoop, 0.0);
+    benchReport("writeInt32Array ", writeArray, writeLoop);
+    benchReport("readInt32 loop  ", readLoop, 0.0);
+    benchReport("readInt32Array  ", readArray, readLoop);
+}
+
+} // anonymous namespace
+
+void o3d::net::benchArray()
+{
+    const System::ByteOrder native = System::getNativeByteOrder();
+    const System::ByteOrder foreign = native == System::ORDER_BIG_ENDIAN ?
+                System::ORDER_LITTLE_ENDIAN : System::ORDER_BIG_ENDIAN;
+
+    benchOrder(native, "Native byte order");
+    benchOrder(foreign, "Foreign byte order");
+}
@@ -0,0 +1,307 @@
+/**
+ * @file benchbuffer.cpp
+ * @brief Codec microbenchmarks of ArrayNetBuffer, printed as JSON.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details Every read/write primitive is measured in both byte orders, through the
+ * NetBuffer interface as message classes use it. The output is a single JSON
+ * document, to be compared between releases.
+ */
+
+#include <o3d/core/architecture.h>
+#include <o3d/core/base.h>
+#include <o3d/core/main.h>
+
+#include "bench.h"
+
+#include "o3d/net/netbuffer.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace o3d;
+using namespace o3d::net;
+
+namespace {
+
+const UInt32 OPERATIONS = 1024;   //!< operations per iteration
+const UInt32 ITERATIONS = 2000;
+const UInt32 BUFFER_SIZE = 64*1024;
+
+struct BenchResult
+{
+    const Char *op;
+    System::ByteOrder order;
+    Double nsPerOp;
+    Double bytesPerOp;
+};
+
+std::vector<BenchResult> ms_results;
+
+// prevent the reads to be optimized out
+volatile UInt64 ms_sink = 0;
+
+void addResult(const Char *op, System::ByteOrder order, Double nsPerOp, Double bytesPerOp)
+{
+    BenchResult result;
+
+    result.op = op;
+    result.order = order;
+    result.nsPerOp = nsPerOp;
+    result.bytesPerOp = bytesPerOp;
+
+    ms_results.push_back(result);
+}
+
+//! Measure OPERATIONS writes then OPERATIONS reads of the written data.
+template <class WRITE, class READ>
+void benchPrimitive(
+        NetBuffer *buffer,
+        const Char *writeName,
+        const Char *readName,
+        WRITE write,
+        READ read)
+{
+    const System::ByteOrder order = buffer->getByteOrder();
+
+    const Double writeNs = benchMeasure(ITERATIONS, [&] () {
+        buffer->setPosition(0);
+        buffer->setLimit(0);
+
+        for (UInt32 i = 0; i < OPERATIONS; ++i)
+        {
+            write(i);
+        }
+    });
+
+    const Double bytesPerOp = Double(buffer->getLimit()) / OPERATIONS;
+    addResult(writeName, order, writeNs / OPERATIONS, bytesPerOp);
+
+    const Double readNs = benchMeasure(ITERATIONS, [&] () {
+        buffer->setPosition(0);
+
+        UInt64 sum = 0;
+        for (UInt32 i = 0; i < OPERATIONS; ++i)
+        {
+            sum += read();
+        }
+
+        ms_sink = ms_sink + sum;
+    });
+
+    addResult(readName, order, readNs / OPERATIONS, bytesPerOp);
+}
+
+void benchOrder(System::ByteOrder order)
+{
+    ArrayNetBuffer array(BUFFER_SIZE);
+    array.setByteOrder(order);
+
+    NetBuffer *buffer = &array;
+
+    benchPrimitive(buffer, "writeInt8", "readInt8",
+                   [&] (UInt32 i) { buffer->writeInt8(Int8(i)); },
+                   [&] () { return UInt64(buffer->readInt8()); });
+
+    benchPrimitive(buffer, "writeUInt8", "readUInt8",
+                   [&] (UInt32 i) { buffer->writeUInt8(UInt8(i)); },
+                   [&] () { return UInt64(buffer->readUInt8()); });
+
+    benchPrimitive(buffer, "writeInt16", "readInt16",
+                   [&] (UInt32 i) { buffer->writeInt16(Int16(i)); },
+                   [&] () { return UInt64(buffer->readInt16()); });
+
+    benchPrimitive(buffer, "writeUInt16", "readUInt16",
+                   [&] (UInt32 i) { buffer->writeUInt16(UInt16(i)); },
+                   [&] () { return UInt64(buffer->readUInt16()); });
+
+    benchPrimitive(buffer, "writeInt32", "readInt32",
+                   [&] (UInt32 i) { buffer->writeInt32(Int32(i * 2654435761u)); },
+                   [&] () { return UInt64(buffer->readInt32()); });
+
+    benchPrimitive(buffer, "writeUInt32", "readUInt32",
+                   [&] (UInt32 i) { buffer->writeUInt32(i * 2654435761u); },
+                   [&] () { return UInt64(buffer->readUInt32()); });
+
+    benchPrimitive(buffer, "writeInt64", "readInt64",
+                   [&] (UInt32 i) { buffer->writeInt64(Int64(i) * 0x9E3779B97F4A7C15LL); },
+                   [&] () { return UInt64(buffer->readInt64()); });
+
+    benchPrimitive(buffer, "writeUInt64", "readUInt64",
+                   [&] (UInt32 i) { buffer->writeUInt64(UInt64(i) * 0x9E3779B97F4A7C15ULL); },
+                   [&] () { return buffer->readUInt64(); });
+
+    benchPrimitive(buffer, "writeBool", "readBool",
+                   [&] (UInt32 i) { buffer->writeBool((i & 1) != 0); },
+                   [&] () { return UInt64(buffer->readBool()); });
+
+    benchPrimitive(buffer, "writeVarUInt32", "readVarUInt32",
+                   [&] (UInt32 i) { buffer->writeVarUInt32(i * 37); },
+                   [&] () { return UInt64(buffer->readVarUInt32()); });
+
+    benchPrimitive(buffer, "writeVarInt64", "readVarInt64",
+                   [&] (UInt32 i) { buffer->writeVarInt64(Int64(i) * -1234567); },
+                   [&] () { return UInt64(buffer->readVarInt64()); });
+
+    // 32 bytes blocks
+    UInt8 block[32];
+    for (UInt32 i = 0; i < 32; ++i)
+    {
+        block[i] = UInt8(i);
+    }
+
+    benchPrimitive(buffer, "write", "read",
+                   [&] (UInt32) { buffer->write(block, 32); },
+                   [&] () { buffer->read(block, 32); return UInt64(block[0]); });
+
+    // arrays of 8 elements, a single bounds check and a bulk byte swap per call
+    const UInt32 ARRAY_SIZE = 8;
+
+    Int16 int16s[ARRAY_SIZE];
+    UInt16 uint16s[ARRAY_SIZE];
+    Int32 int32s[ARRAY_SIZE];
+    UInt32 uint32s[ARRAY_SIZE];
+    Int64 int64s[ARRAY_SIZE];
+    UInt64 uint64s[ARRAY_SIZE];
+    Float floats[ARRAY_SIZE];
+    Double doubles[ARRAY_SIZE];
+
+    for (UInt32 i = 0; i < ARRAY_SIZE; ++i)
+    {
+        int16s[i] = Int16(i * 40503u);
+        uint16s[i] = UInt16(i * 40503u);
+        int32s[i] = Int32(i * 2654435761u);
+        uint32s[i] = i * 2654435761u;
+        int64s[i] = Int64(i) * 0x9E3779B97F4A7C15LL;
+        uint64s[i] = UInt64(i) * 0x9E3779B97F4A7C15ULL;
+        floats[i] = Float(i) * 1.25f;
+        doubles[i] = Double(i) * 1.25;
+    }
+
+    benchPrimitive(buffer, "writeInt16Array", "readInt16Array",
+                   [&] (UInt32) { buffer->writeInt16Array(int16s, ARRAY_SIZE); },
+                   [&] () { buffer->readInt16Array(int16s, ARRAY_SIZE); return UInt64(int16s[1]); });
+
+    benchPrimitive(buffer, "writeUInt16Array", "readUInt16Array",
+                   [&] (UInt32) { buffer->writeUInt16Array(uint16s, ARRAY_SIZE); },
+                   [&] () { buffer->readUInt16Array(uint16s, ARRAY_SIZE); return UInt64(uint16s[1]); });
+
+    benchPrimitive(buffer, "writeInt32Array", "readInt32Array",
+                   [&] (UInt32) { buffer->writeInt32Array(int32s, ARRAY_SIZE); },
+                   [&] () { buffer->readInt32Array(int32s, ARRAY_SIZE); return UInt64(int32s[1]); });
+
+    benchPrimitive(buffer, "writeUInt32Array", "readUInt32Array",
+                   [&] (UInt32) { buffer->writeUInt32Array(uint32s, ARRAY_SIZE); },
+                   [&] () { buffer->readUInt32Array(uint32s, ARRAY_SIZE); return UInt64(uint32s[1]); });
+
+    benchPrimitive(buffer, "writeInt64Array", "readInt64Array",
+                   [&] (UInt32) { buffer->writeInt64Array(int64s, ARRAY_SIZE); },
+                   [&] () { buffer->readInt64Array(int64s, ARRAY_SIZE); return UInt64(int64s[1]); });
+
+    benchPrimitive(buffer, "writeUInt64Array", "readUInt64Array",
+                   [&] (UInt32) { buffer->writeUInt64Array(uint64s, ARRAY_SIZE); },
+                   [&] () { buffer->readUInt64Array(uint64s, ARRAY_SIZE); return uint64s[1]; });
+
+    benchPrimitive(buffer, "writeFloatArray", "readFloatArray",
+                   [&] (UInt32) { buffer->writeFloatArray(floats, ARRAY_SIZE); },
+                   [&] () { buffer->readFloatArray(floats, ARRAY_SIZE); return UInt64(floats[1]); });
+
+    benchPrimitive(buffer, "writeDoubleArray", "readDoubleArray",
+                   [&] (UInt32) { buffer->writeDoubleArray(doubles, ARRAY_SIZE); },
+                   [&] () { buffer->readDoubleArray(doubles, ARRAY_SIZE); return UInt64(doubles[1]); });
+
+    // 24 characters strings, as String and as C string
+    const Char *cstring = "o3d::net::ArrayNetBuffer";
+    const String string(cstring);
+    String resultString;
+    Char resultCString[33];   // readUTF8(Char*) adds the null terminator
+
+    benchPrimitive(buffer, "writeUTF8", "readUTF8",
+                   [&] (UInt32) { buffer->writeUTF8(string); },
+                   [&] () { buffer->readUTF8(resultString); return UInt64(resultString.length()); });
+
+    benchPrimitive(buffer, "writeUTF8(Char*)", "readUTF8(Char*)",
+                   [&] (UInt32) { buffer->writeUTF8(cstring); },
+                   [&] () {
+                       // readUTF8(Char*) does not read the length prefix
+                       const Int16 size = buffer->readInt16();
+                       buffer->readUTF8(resultCString, size);
+                       return UInt64(resultCString[0]); });
+
+    // compact half of the buffer, moving the other half
+    const UInt32 half = BUFFER_SIZE / 2;
+
+    const Double compactNs = benchMeasure(ITERATIONS, [&] () {
+        buffer->setLimit(BUFFER_SIZE);
+        buffer->setPosition(half);
+        buffer->compact();
+    });
+
+    addResult("compact", order, compactNs, half);
+
+    const Double flipNs = benchMeasure(ITERATIONS, [&] () {
+        for (UInt32 i = 0; i < OPERATIONS; ++i)
+        {
+            buffer->flip();
+        }
+    });
+
+    addResult("flip", order, flipNs / OPERATIONS, 0);
+}
+
+const Char* orderName(System::ByteOrder order)
+{
+    return order == System::ORDER_BIG_ENDIAN ? "big" : "little";
+}
+
+void printResults()
+{
+    const System::ByteOrder native = System::getNativeByteOrder();
+
+    printf("{\n");
+    printf("  \"benchmark\": \"o3dnet-bench-buffer\",\n");
+    printf("  \"buffer\": \"ArrayNetBuffer\",\n");
+    printf("  \"native_order\": \"%s\",\n", orderName(native));
+    printf("  \"operations\": %u,\n", OPERATIONS);
+    printf("  \"iterations\": %u,\n", ITERATIONS);
+    printf("  \"results\": [\n");
+
+    for (size_t i = 0; i < ms_results.size(); ++i)
+    {
+        const BenchResult &result = ms_results[i];
+
+        // bytes per ns is GB/s
+        const Double gbPerSec = result.nsPerOp > 0.0 ? result.bytesPerOp / result.nsPerOp : 0.0;
+
+        printf("    { \"op\": \"%s\", \"order\": \"%s\", \"ns_per_op\": %.3f, \"bytes_per_op\": %.2f, \"gb_per_s\": %.3f }%s\n",
+               result.op,
+               orderName(result.order),
+               result.nsPerOp,
+               result.bytesPerOp,
+               gbPerSec,
+               i + 1 < ms_results.size() ? "," : "");
+    }
+
+    printf("  ]\n");
+    printf("}\n");
+}
+
+} // anonymous namespace
+
+class BenchBuffer
+{
+public:
+
+    static Int32 main()
+    {
+        benchOrder(System::ORDER_LITTLE_ENDIAN);
+        benchOrder(System::ORDER_BIG_ENDIAN);
+
+        printResults();
+
+        return 0;
+    }
+};
+
+O3D_CONSOLE_MAIN(BenchBuffer, O3D_DEFAULT_CLASS_SETTINGS)
@@ -0,0 +1,31 @@
+/**
+ * @file main.cpp
+ * @brief Main entry of the network microbenchmarks.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include <o3d/core/architecture.h>
+#include <o3d/core/base.h>
+#include <o3d/core/main.h>
+
+#include "bench.h"
+
+using namespace o3d;
+using namespace o3d::net;
+
+class Bench
+{
+public:
+
+    static Int32 main()
+    {
+        benchArray();
+
+        return 0;
+    }
+};
+
+O3D_CONSOLE_MAIN(Bench, O3D_DEFAULT_CLASS_SETTINGS)
@@ -0,0 +1,88 @@
+/**
+ * @file batchnetmessageadapter.h
+ * @brief Read/write adapter coalescing the messages of a write pass in a batch frame.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_BATCHNETMESSAGEADAPTER_H
+#define _O3D_BATCHNETMESSAGEADAPTER_H
+
+#include "netmessageadapter.h"
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Read/write adapter packing the messages of a write pass in a single frame.
+ * @details The messages drained by one handleWrite pass are written in a batch frame:
+ * a 0xFF lead byte (never a valid message code lead byte), the batch size in a 3 bytes
+ * varint, and the messages. Each message has a compact header, its multi-byte code
+ * followed by its size in a minimal varint when the message declares it (1 byte for
+ * messages lesser than 128 bytes), else in a 3 bytes varint patched after the
+ * serialization. A message written outside of a pass gets the same header, without
+ * batch frame.
+ * On receive the whole batch is waited for once, then its messages are split back
+ * without any more check of the available data.
+ * Message sizes, declared or not, are limited to 65535 bytes.
+ * Both peers must use this adapter.
+ * @note The adapter keeps the state of the current batch, so each connection must
+ * have its own instance (@see NetReadWriteAdapterFactory).
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+class O3D_NET_API BatchNetMessageAdapter : public NetReadWriteAdapter
+{
+public:
+
+    BatchNetMessageAdapter();
+    virtual ~BatchNetMessageAdapter();
+
+    virtual NetMessage* readFrom(NetBuffer* buffer, NetMessage* message);
+    virtual NetMessage* writeTo(NetBuffer* buffer, NetMessage* message);
+
+    virtual void beginWrite(NetBuffer* buffer);
+    virtual void endWrite(NetBuffer* buffer);
+
+    virtual Bool readHeader(NetBuffer* buffer);
+
+    //! Always false, the adapter keeps the state of the current batch.
+    virtual Bool isShareable() const;
+
+    //! Lead byte of a batch frame.
+    static const UInt8 BATCH_LEAD = 0xFF;
+
+    //! A batch is closed and another one opened once it reaches this size.
+    static const UInt32 MAX_BATCH_SIZE = 0xffff;
+
+    //! Number of batches written.
+    inline UInt32 getNumBatches() const { return m_numBatches; }
+
+    //! Number of messages written.
+    inline UInt32 getNumMessages() const { return m_numMessages; }
+
+private:
+
+    Bool m_writing;          //!< inside a write pass
+    Bool m_batchOpen;        //!< a batch frame is being written
+    UInt32 m_batchSlot;      //!< reserved batch size
+    UInt32 m_batchStart;     //!< limit of the buffer after the batch header
+
+    UInt32 m_batchRest;      //!< bytes of the received batch not read yet
+    UInt32 m_batchMark;      //!< available bytes before the current message code
+
+    UInt32 m_numBatches;
+    UInt32 m_numMessages;
+
+    void closeBatch(NetBuffer *buffer);
+
+    //! Drop a partial message frame, and close or drop its batch.
+    void dropFrame(NetBuffer *buffer, UInt32 frameStart, Bool openBatch);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_BATCHNETMESSAGEADAPTER_H
@@ -0,0 +1,146 @@
+/**
+ * @file bitnetbuffer.h
+ * @brief Bit-level packing cursors over a NetBuffer.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_BITNETBUFFER_H
+#define _O3D_BITNETBUFFER_H
+
+#include "netbuffer.h"
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Bit-level writer over any NetBuffer.
+ * @details Fields are packed lowest bit first into a 64 bits scratch, that is
+ * written to the buffer 32 bits at a time, in little-endian whatever the byte order
+ * of the buffer. flush() writes the last partial byte, padded with zeros, so that
+ * byte-granular fields can follow.
+ * For example a bool costs 1 bit, an enum of 5 values 3 bits, and a coordinate in
+ * [-1000..1000] at a 1/16 precision 15 bits.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API BitNetWriter
+{
+public:
+
+    //! The buffer must outlive the writer. Call flush() once every field is written.
+    BitNetWriter(NetBuffer *buffer);
+
+    /**
+     * @brief writeBits Write the lowest bits of a value.
+     * @param value Value, the bits above the count are ignored.
+     * @param bits Number of bits in [0..32].
+     */
+    inline void writeBits(UInt32 value, UInt32 bits)
+    {
+        if (bits == 0)
+            return;
+
+        m_scratch |= static_cast<UInt64>(value & (0xffffffffu >> (32 - bits))) << m_scratchBits;
+        m_scratchBits += bits;
+        m_bitCount += bits;
+
+        if (m_scratchBits >= 32)
+            flushWord();
+    }
+
+    inline void writeBool(Bool value) { writeBits(value ? 1 : 0, 1); }
+
+    //! Write an integer in [min..max] on the minimal number of bits, clamped to the range.
+    void writeRangedInt(Int32 value, Int32 min, Int32 max);
+
+    //! Write a float in [min..max] quantized to the given precision (1/16 for example),
+    //! clamped to the range.
+    void writeFixedFloat(Float value, Float min, Float max, Float precision);
+
+    //! Write the pending bits, the last byte being padded with zeros.
+    void flush();
+
+    //! Number of bits written since the construction.
+    inline UInt32 getBitCount() const { return m_bitCount; }
+
+    //! Number of bits needed to store a value in [0..range].
+    static UInt32 bitsRequired(UInt32 range);
+
+private:
+
+    NetBuffer *m_buffer;
+
+    UInt64 m_scratch;       //!< pending bits, lowest first
+    UInt32 m_scratchBits;   //!< number of pending bits
+    UInt32 m_bitCount;      //!< total number of bits written
+
+    void flushWord();
+};
+
+/**
+ * @brief Bit-level reader over any NetBuffer, the counterpart of BitNetWriter.
+ * @details Bytes are pulled from the buffer only when needed, so the reader never
+ * consumes bytes past the last one written by the BitNetWriter::flush().
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API BitNetReader
+{
+public:
+
+    //! The buffer must outlive the reader.
+    BitNetReader(NetBuffer *buffer);
+
+    /**
+     * @brief readBits Read an unsigned value.
+     * @param bits Number of bits in [0..32].
+     * @exception E_BufferOverflow if the buffer has not enough bytes.
+     */
+    inline UInt32 readBits(UInt32 bits)
+    {
+        if (bits == 0)
+            return 0;
+
+        if (m_scratchBits < bits)
+            fill(bits);
+
+        const UInt32 value = static_cast<UInt32>(m_scratch) & (0xffffffffu >> (32 - bits));
+        m_scratch >>= bits;
+        m_scratchBits -= bits;
+        m_bitCount += bits;
+
+        return value;
+    }
+
+    inline Bool readBool() { return readBits(1) != 0; }
+
+    //! Read an integer written with BitNetWriter::writeRangedInt.
+    Int32 readRangedInt(Int32 min, Int32 max);
+
+    //! Read a float written with BitNetWriter::writeFixedFloat.
+    Float readFixedFloat(Float min, Float max, Float precision);
+
+    //! Drop the padding bits of the current byte, to read byte-granular fields after.
+    void align();
+
+    //! Number of bits read since the construction.
+    inline UInt32 getBitCount() const { return m_bitCount; }
+
+private:
+
+    NetBuffer *m_buffer;
+
+    UInt64 m_scratch;       //!< pending bits, lowest first
+    UInt32 m_scratchBits;   //!< number of pending bits
+    UInt32 m_bitCount;      //!< total number of bits read
+
+    void fill(UInt32 bits);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_BITNETBUFFER_H
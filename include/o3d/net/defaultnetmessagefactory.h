@@ -16,12 +16,21 @@
 namespace o3d {
 namespace net {
 
+class NetMessagePool;
+class RawNetMessageIn;
+
 /**
  * @brief The Default net message factory
  * @details Register and manage the version and generic message.
  * Build message from NetBuffer according to registred net message, and using
  * a dynamique net message type from 1 to 4 bytes. It can be used with the
  * DefaultNetMessageAdapter.
+ * The code is decoded in constant time, its length and bits being given by a table
+ * of the lead byte, and the message is found in a dense table indexed by code.
+ * Optionally the incoming messages are recycled through a NetMessagePool, in place
+ * of a new instance per message. They are then given back by their release().
+ * In passthrough mode the messages of the unregistered codes are kept raw, to be
+ * forwarded by a proxy without being decoded.
  * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
  * @date 2013-07-22
  */
@@ -29,16 +38,36 @@ class O3D_NET_API DefaultNetMessageFactory : public NetMessageFactory
 {
 public:
 
-    DefaultNetMessageFactory();
+    /**
+     * @brief DefaultNetMessageFactory
+     * @param pooling Recycle the incoming messages of the registered types.
+     */
+    DefaultNetMessageFactory(Bool pooling = False);
 
     virtual ~DefaultNetMessageFactory();
     virtual NetMessage* buildFromBuffer(NetBuffer* buffer);
 
     virtual void registerMsg(AbstractNetMessageIn *msg);
 
+    //! Pool of the incoming messages, or null if the pooling is disabled.
+    inline NetMessagePool* getPool() const { return m_pool; }
+
+    /**
+     * @brief setPassthrough Build the messages of the unregistered codes from a raw
+     *        message prototype, in place of skipping them with a GenericMessageIn.
+     * @param prototype Raw message prototype, owned by the factory, or null to disable.
+     * @note Must be set before any message is built.
+     */
+    void setPassthrough(RawNetMessageIn *prototype);
+
+    //! Raw message prototype of the passthrough mode, or null if disabled.
+    inline RawNetMessageIn* getPassthrough() const { return m_passthrough; }
+
 protected:
 
     std::vector<AbstractNetMessageIn*> m_msg;
+    NetMessagePool *m_pool;
+    RawNetMessageIn *m_passthrough;
 };
 
 } // namespace net
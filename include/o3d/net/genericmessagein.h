@@ -31,11 +31,11 @@ public:
 
     virtual void run(void *context);
 
-    virtual void setMessageSize(UInt16 dataSize);
+    virtual void setMessageSize(UInt32 dataSize);
 
 private:
 
-    Int16 m_rest;
+    UInt32 m_rest;
 };
 
 } // namespace net
@@ -0,0 +1,139 @@
+/**
+ * @file largenetmessageadapter.h
+ * @brief Read/write adapter for messages larger than 64KB, with optional streaming.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_LARGENETMESSAGEADAPTER_H
+#define _O3D_LARGENETMESSAGEADAPTER_H
+
+#include "netmessageadapter.h"
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Abstract message class incoming, whose payload is received by chunks.
+ * @details With a streaming LargeNetMessageAdapter, readChunk() is called each time
+ * a part of the payload is received, so a large payload can be processed (or stored)
+ * without being entirely buffered. Any other adapter gives the whole payload in a
+ * single chunk.
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+class O3D_NET_API AbstractNetMessageStreamIn : public AbstractNetMessageIn
+{
+    friend class LargeNetMessageAdapter;
+
+public:
+
+    AbstractNetMessageStreamIn() :
+        m_received(0),
+        m_streaming(False)
+    {
+    }
+
+    /**
+     * @brief readChunk Read the next chunk of the payload.
+     * @param buffer Buffer with at least size readable bytes.
+     * @param offset Number of bytes of the payload already read.
+     * @param size Number of bytes to read exactly, getMessageSize() bytes in total.
+     */
+    virtual void readChunk(NetBuffer *buffer, UInt32 offset, UInt32 size) = 0;
+
+    //! Give the whole payload as a single chunk.
+    virtual NetMessage* readFromBuffer(NetBuffer *buffer);
+
+    virtual void recycle();
+
+    virtual AbstractNetMessageStreamIn* asStreamIn() { return this; }
+
+    //! Number of bytes of the payload read.
+    inline UInt32 getReceivedSize() const { return m_received; }
+
+private:
+
+    UInt32 m_received;
+    Bool m_streaming;    //!< size header read, waiting for the rest of the payload
+};
+
+/**
+ * @brief Abstract message class incoming by chunks helper
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+template <class CLASS, UInt32 CODE>
+class O3D_NET_API_TEMPLATE NetMessageStreamInHelper : public AbstractNetMessageStreamIn
+{
+public:
+
+    virtual UInt32 getMessageCode() const { return CODE; }
+    static AbstractNetMessageIn* createInstance() { return new CLASS; }
+    virtual AbstractNetMessageIn* makeInstance() const { return new CLASS; }
+};
+
+/**
+ * @brief Read/write adapter for messages larger than 64KB.
+ * It uses the same multi-byte message code than DefaultNetMessageAdapter, followed by
+ * the message size in a 32 bits integer, or in a varint (1 byte for messages lesser
+ * than 128 bytes). The size slot is reserved and patched after the serialization,
+ * on 4 bytes or on a 5 bytes varint, unless the message declares its size.
+ * An incoming message is read once its whole payload is in the buffer, so the read
+ * buffer must be able to hold the largest message, with its header, else it is
+ * rejected. The default maximal size fits the default SegmentedNetBuffer. In streaming mode the messages
+ * inheriting from AbstractNetMessageStreamIn are given their payload chunk by chunk
+ * as soon as it is received, and only the other messages are buffered.
+ * Both peers must use the same size framing. It can be used with the
+ * DefaultNetMessageFactory.
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+class O3D_NET_API LargeNetMessageAdapter : public NetReadWriteAdapter
+{
+public:
+
+    //! Largest header, a 4 bytes message code and a 5 bytes varint size.
+    static const UInt32 MAX_HEADER_SIZE = 9;
+
+    /**
+     * @brief LargeNetMessageAdapter
+     * @param varIntSize Frame the message size as a varint instead of a 32 bits integer.
+     * @param streaming Give the payload of the streamed messages by chunks.
+     * @param maxMessageSize Larger incoming or outgoing messages are rejected.
+     */
+    LargeNetMessageAdapter(
+            Bool varIntSize = False,
+            Bool streaming = False,
+            UInt32 maxMessageSize = 16*1024*1024 - MAX_HEADER_SIZE);
+
+    virtual ~LargeNetMessageAdapter();
+
+    virtual NetMessage* readFrom(NetBuffer* buffer, NetMessage* message);
+    virtual NetMessage* writeTo(NetBuffer* buffer, NetMessage* message);
+
+    //! True if the message size is framed as a varint.
+    inline Bool isVarIntSize() const { return m_varIntSize; }
+
+    //! True if the streamed messages are given their payload by chunks.
+    inline Bool isStreaming() const { return m_streaming; }
+
+    //! Maximal size of a message payload.
+    inline UInt32 getMaxMessageSize() const { return m_maxMessageSize; }
+
+private:
+
+    Bool m_varIntSize;
+    Bool m_streaming;
+    UInt32 m_maxMessageSize;
+
+    //! Give the received part of the payload to a streamed message.
+    NetMessage* readChunk(NetBuffer *buffer, AbstractNetMessageStreamIn *message);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_LARGENETMESSAGEADAPTER_H
@@ -0,0 +1,93 @@
+/**
+ * @file mmapnetbuffer.h
+ * @brief Buffer on top of a memory-mapped file, for spooling very large payloads.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MMAPNETBUFFER_H
+#define _O3D_MMAPNETBUFFER_H
+
+#include "netbuffer.h"
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Buffer on top of a memory-mapped file, for spooling very large payloads.
+ * @details The whole capacity is mapped at once, so writes land directly into the
+ * mapped pages and the readable span covers everything written, letting
+ * Socket::sendFromBuffer push a payload of hundreds of MB without any heap copy.
+ * The pages are only backed by the file, the kernel writes them back and evicts
+ * them as needed.
+ * Unlike ArrayNetBuffer, compact() never moves the data, it gives back the pages
+ * already read to the system, and rewinds the positions once fully drained.
+ * The capacity is limited to 2GB by the NetBuffer positions.
+ * Default byte-order is system native.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API MmapNetBuffer : public ArrayNetBuffer
+{
+public:
+
+    enum OpenMode
+    {
+        OPEN_READ = 0,    //!< Existing file, entirely readable, never modified.
+        OPEN_WRITE        //!< File created or truncated to the capacity, empty.
+    };
+
+    /**
+     * @brief MmapNetBuffer on an anonymous temporary file, deleted at the destruction.
+     * @param capacity Size in bytes of the file.
+     * @param directory Directory of the temporary file, default is TMPDIR or /tmp.
+     * @note Prefer a disk directory to a tmpfs one, which is backed by memory.
+     */
+    MmapNetBuffer(UInt32 capacity, const String &directory = String());
+
+    /**
+     * @brief MmapNetBuffer on a caller-supplied file.
+     * @param filename Path of the file.
+     * @param mode OPEN_READ to send an existing file, OPEN_WRITE to spool into a file.
+     * @param capacity Size in bytes of the file for OPEN_WRITE, unused for OPEN_READ.
+     */
+    MmapNetBuffer(const String &filename, OpenMode mode, UInt32 capacity = 0);
+
+    virtual ~MmapNetBuffer();
+
+    //! Give back the pages already read, and rewind once fully drained.
+    virtual void compact();
+
+    //! Bytes left after the limit, the bytes already read are only reused once drained.
+    virtual Int32 getFree() const;
+
+    //! Size in bytes of the mapping.
+    inline UInt32 getCapacity() const { return m_mapping.size; }
+
+private:
+
+    struct Mapping
+    {
+        UInt8 *data;
+        UInt32 size;
+        void *handle;   //!< file mapping handle (Windows only)
+    };
+
+    Mapping m_mapping;
+    UInt32 m_released;  //!< pages released before this offset
+
+    MmapNetBuffer(const Mapping &mapping, Bool readable);
+
+    static Mapping mapTemporary(UInt32 capacity, const String &directory);
+    static Mapping mapFile(const String &filename, OpenMode mode, UInt32 capacity);
+    static void unmap(Mapping &mapping);
+
+    void releasePages(UInt32 offset);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_MMAPNETBUFFER_H
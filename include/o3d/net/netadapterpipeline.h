@@ -0,0 +1,139 @@
+/**
+ * @file netadapterpipeline.h
+ * @brief Read/write adapter chaining transform stages over the message frames.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETADAPTERPIPELINE_H
+#define _O3D_NETADAPTERPIPELINE_H
+
+#include "netmessageadapter.h"
+
+#include <vector>
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief A transform stage of a NetAdapterPipeline (compression, checksum...).
+ * @details A stage transforms a whole frame, the payload of a message, into a scratch
+ * array owned by the pipeline and reused from frame to frame. A stage can keep a state
+ * from frame to frame, the frames being encoded and decoded in the same order on
+ * both peers.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetAdapterStage
+{
+public:
+
+    virtual ~NetAdapterStage() = 0;
+
+    /**
+     * @brief encode Encode a frame.
+     * @param data Frame bytes.
+     * @param size Frame size in bytes.
+     * @param out Encoded frame, resized by the stage.
+     * @return False to pass through, the frame is then left as is and out is ignored.
+     */
+    virtual Bool encode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out) = 0;
+
+    /**
+     * @brief decode Decode a frame encoded (not passed through) by this stage.
+     * @param data Encoded frame bytes.
+     * @param size Encoded frame size in bytes.
+     * @param out Decoded frame, resized by the stage.
+     * @exception E_BufferException if the frame is invalid.
+     */
+    virtual void decode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out) = 0;
+
+    /**
+     * @brief getMaxEncodedSize Worst case size of an encoded frame.
+     * @return Default returns size, a stage that can grow a frame must override it.
+     */
+    virtual UInt32 getMaxEncodedSize(UInt32 size) const;
+};
+
+/**
+ * @brief Integrity stage, appending a CRC-32 of the frame.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetChecksumStage : public NetAdapterStage
+{
+public:
+
+    virtual Bool encode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out);
+    virtual void decode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out);
+
+    //! Frame size plus 4 bytes.
+    virtual UInt32 getMaxEncodedSize(UInt32 size) const;
+
+    //! CRC-32 (IEEE 802.3) of an array.
+    static UInt32 crc32(const UInt8 *data, UInt32 size);
+};
+
+/**
+ * @brief Read/write adapter chaining stages over the payload of each message.
+ * @details Each message is framed with its multi-byte code, a byte with a bit per
+ * stage that encoded it, and the size of the encoded payload in a varint. The code
+ * stays in clear, so a proxy can still route the messages.
+ * On write the message is serialized into a scratch buffer, then given to the stages
+ * in order, each one encoding into one of two scratch arrays used in turn, or passing
+ * through. On read the stages decode in the reverse order, and the message reads the
+ * decoded frame in place. A frame that no stage encoded is read directly from the
+ * read buffer, without any copy.
+ * With no stage the framing is the one of the DefaultNetMessageAdapter in varint mode,
+ * plus the stage byte.
+ * Frames are limited to 65535 bytes before and after the worst case encoding. The
+ * write buffer must have room for the worst case before any stage runs, else the
+ * message is returned, so a stage state never gets ahead of the peer one. Both peers
+ * must use the same stages in the same order.
+ * @note Stages can have a state, and the scratch buffers are used by each read and
+ * write, so each connection must have its own pipeline (@see NetReadWriteAdapterFactory).
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetAdapterPipeline : public NetReadWriteAdapter
+{
+public:
+
+    //! Maximum number of stages.
+    static const UInt32 MAX_STAGES = 8;
+
+    //! Maximum size of a frame, before and after encoding.
+    static const UInt32 MAX_FRAME_SIZE = 0xffff;
+
+    NetAdapterPipeline();
+    virtual ~NetAdapterPipeline();
+
+    //! Append a stage, owned by the pipeline.
+    void addStage(NetAdapterStage *stage);
+
+    //! Number of stages.
+    inline UInt32 getNumStages() const { return (UInt32)m_stages.size(); }
+
+    //! Get a stage.
+    inline NetAdapterStage* getStage(UInt32 index) const { return m_stages[index]; }
+
+    virtual NetMessage* readFrom(NetBuffer* buffer, NetMessage* message);
+    virtual NetMessage* writeTo(NetBuffer* buffer, NetMessage* message);
+
+    //! Always false, a pipeline belongs to a single connection.
+    virtual Bool isShareable() const;
+
+private:
+
+    std::vector<NetAdapterStage*> m_stages;
+
+    ArrayNetBuffer *m_scratch;           //!< serialized outgoing message
+    std::vector<UInt8> m_frames[2];      //!< encoded or decoded frames, used in turn
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETADAPTERPIPELINE_H
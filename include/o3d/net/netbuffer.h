@@ -15,9 +15,99 @@
 #include <o3d/core/base.h>
 #include <o3d/core/error.h>
 
+#include <cstring>
+#include <vector>
+
 namespace o3d {
 namespace net {
 
+class NetBufferArena;
+class NetStringTable;
+
+//---------------------------------------------------------------------------------------
+//! @class NetStringView
+//-------------------------------------------------------------------------------------
+//! Non owning UTF-8 string read from a NetBuffer, not null terminated.
+//! It points into the buffer and is valid until the next write or compact of
+//! the buffer. When the string straddles two segments it is copied into the view.
+//---------------------------------------------------------------------------------------
+class O3D_NET_API NetStringView
+{
+	friend class NetBuffer;
+
+public:
+
+	NetStringView() :
+		m_data(nullptr),
+		m_length(0)
+	{
+	}
+
+	//! UTF-8 data, not null terminated.
+	inline const Char* getData() const { return m_data; }
+
+	//! Length in bytes.
+	inline UInt32 length() const { return m_length; }
+
+	inline Bool isEmpty() const { return m_length == 0; }
+
+	//! Compare to a null terminated UTF-8 string.
+	inline Bool operator== (const Char *string) const
+	{
+		return (strlen(string) == m_length) && (memcmp(m_data, string, m_length) == 0);
+	}
+
+	inline Bool operator!= (const Char *string) const { return !(*this == string); }
+
+	//! Compare to an UTF-8 string of a given length.
+	inline Bool equals(const Char *string, UInt32 length) const
+	{
+		return (length == m_length) && (memcmp(m_data, string, m_length) == 0);
+	}
+
+	//! Make an owned copy.
+	inline String toString() const
+	{
+		String string;
+		if (m_length > 0)
+			string.fromUtf8(m_data, m_length);
+		return string;
+	}
+
+private:
+
+	const Char *m_data;
+	UInt32 m_length;
+	std::vector<Char> m_copy;   //!< only used for a non contiguous string
+};
+
+//! Contiguous region of a buffer, for scatter/gather I/O.
+struct NetBufferSegment
+{
+	UInt8 *data;
+	UInt32 size;
+};
+
+//---------------------------------------------------------------------------------------
+//! @class NetFrameListener
+//-------------------------------------------------------------------------------------
+//! Notified once the message frame it has been written in is committed or dropped
+//! by the adapter, to keep a per-connection state in sync with what is really sent.
+//! @see NetBuffer::addFrameListener
+//---------------------------------------------------------------------------------------
+class O3D_NET_API NetFrameListener
+{
+public:
+
+	virtual ~NetFrameListener() = 0;
+
+	//! The frame is written, it will be sent.
+	virtual void frameCommitted() = 0;
+
+	//! The frame is dropped, it will never be sent.
+	virtual void frameDropped() = 0;
+};
+
 //---------------------------------------------------------------------------------------
 //! @class NetBuffer
 //-------------------------------------------------------------------------------------
@@ -27,6 +117,10 @@ class O3D_NET_API NetBuffer
 {
 public:
 
+	NetBuffer() : m_readMark(0), m_stringTable(nullptr), m_inFrame(False) {}
+
+	virtual ~NetBuffer() = 0;
+
 	virtual void writeInt8(Int8 value) = 0;
     virtual void writeUInt8(UInt8 value) = 0;
 
@@ -59,11 +153,119 @@ public:
 
 	virtual Bool read(UInt8* buffer, Int16 size) = 0;
 
+	//! Write an array of count elements, with a single bounds check.
+	//! @note Same byte order is a memcpy, else a SIMD byte swap.
+	inline void writeInt16Array(const Int16 *values, UInt32 count) { writeElements(reinterpret_cast<const UInt8*>(values), count, 2); }
+	inline void writeUInt16Array(const UInt16 *values, UInt32 count) { writeElements(reinterpret_cast<const UInt8*>(values), count, 2); }
+	inline void writeInt32Array(const Int32 *values, UInt32 count) { writeElements(reinterpret_cast<const UInt8*>(values), count, 4); }
+	inline void writeUInt32Array(const UInt32 *values, UInt32 count) { writeElements(reinterpret_cast<const UInt8*>(values), count, 4); }
+	inline void writeInt64Array(const Int64 *values, UInt32 count) { writeElements(reinterpret_cast<const UInt8*>(values), count, 8); }
+	inline void writeUInt64Array(const UInt64 *values, UInt32 count) { writeElements(reinterpret_cast<const UInt8*>(values), count, 8); }
+	inline void writeFloatArray(const Float *values, UInt32 count) { writeElements(reinterpret_cast<const UInt8*>(values), count, 4); }
+	inline void writeDoubleArray(const Double *values, UInt32 count) { writeElements(reinterpret_cast<const UInt8*>(values), count, 8); }
+
+	//! Read an array of count elements, with a single bounds check.
+	//! @exception E_BufferOverflow if less than count elements are available.
+	inline void readInt16Array(Int16 *values, UInt32 count) { readElements(reinterpret_cast<UInt8*>(values), count, 2); }
+	inline void readUInt16Array(UInt16 *values, UInt32 count) { readElements(reinterpret_cast<UInt8*>(values), count, 2); }
+	inline void readInt32Array(Int32 *values, UInt32 count) { readElements(reinterpret_cast<UInt8*>(values), count, 4); }
+	inline void readUInt32Array(UInt32 *values, UInt32 count) { readElements(reinterpret_cast<UInt8*>(values), count, 4); }
+	inline void readInt64Array(Int64 *values, UInt32 count) { readElements(reinterpret_cast<UInt8*>(values), count, 8); }
+	inline void readUInt64Array(UInt64 *values, UInt32 count) { readElements(reinterpret_cast<UInt8*>(values), count, 8); }
+	inline void readFloatArray(Float *values, UInt32 count) { readElements(reinterpret_cast<UInt8*>(values), count, 4); }
+	inline void readDoubleArray(Double *values, UInt32 count) { readElements(reinterpret_cast<UInt8*>(values), count, 8); }
+
+	//! Write a variable length unsigned integer (1 to 5 bytes).
+	void writeVarUInt32(UInt32 value);
+	//! Write a variable length unsigned integer (1 to 10 bytes).
+	void writeVarUInt64(UInt64 value);
+
+	//! Write a ZigZag variable length signed integer (1 to 5 bytes).
+	void writeVarInt32(Int32 value);
+	//! Write a ZigZag variable length signed integer (1 to 10 bytes).
+	void writeVarInt64(Int64 value);
+
+	//! Read a variable length unsigned integer.
+	//! @exception E_BufferOverflow if the varint is incomplete.
+	//! @exception E_BufferException if the varint is malformed or overflows.
+	UInt32 readVarUInt32();
+	//! Read a variable length unsigned integer.
+	UInt64 readVarUInt64();
+
+	//! Read a ZigZag variable length signed integer.
+	Int32 readVarInt32();
+	//! Read a ZigZag variable length signed integer.
+	Int64 readVarInt64();
+
 	//! Read a string
     virtual Bool readUTF8(Char* string, Int16 size) = 0;
 	virtual Bool readUTF8(String& string) = 0;
 	virtual Bool readBool() = 0;
 
+	//! Read a string without allocation, as a view into the buffer.
+	//! @return False if the size of the string is not available.
+	Bool readUTF8View(NetStringView &view);
+
+	//! Set the string table used by the interned strings, not owned, or null.
+	//! @note A buffer is written or read by a single side of a connection, so the
+	//! read and the write buffers of a connection each need their own table.
+	inline void setStringTable(NetStringTable *table) { m_stringTable = table; }
+
+	//! Get the string table used by the interned strings, or null.
+	inline NetStringTable* getStringTable() const { return m_stringTable; }
+
+	//! Begin, keep or drop a message frame, with the slot definitions of the string
+	//! table (@see NetStringTable::mark) and the frame listeners. Called by the
+	//! adapters around the serialization of each message.
+	void beginFrame();
+	void commitFrame();
+	void rollbackFrame();
+
+	//! Notify a listener, not owned, once the current frame is committed or dropped.
+	//! Outside of a frame the listener is notified as committed at once.
+	void addFrameListener(NetFrameListener *listener);
+
+	//! Write a string through the string table. The first write assigns it a slot and
+	//! sends it with the slot id, the next ones only send the varint id.
+	//! Without a string table, or for a too long string, the string is sent as a literal.
+	void writeInternedUTF8(const String &string);
+	void writeInternedUTF8(const Char *string);
+	void writeInternedUTF8(const Char *string, UInt32 length);
+
+	//! Read a string written with writeInternedUTF8.
+	//! @return False and reading nothing if the string is incomplete.
+	//! @exception E_BufferException if the slot is unknown or out of the capacity.
+	Bool readInternedUTF8(String &string);
+
+	//! Start a read transaction at the read position.
+	//! @note A single transaction at a time, valid until the next compact.
+	inline void mark() { m_readMark = getPosition(); }
+
+	//! True if at least size bytes can be read.
+	inline Bool ensureReadable(UInt32 size) const { return (UInt32)getAvailable() >= size; }
+
+	//! Restore the read position of the last mark, for an incomplete frame.
+	void rollback();
+
+	//! Keep what has been read since the last mark.
+	inline void commit() { m_readMark = getPosition(); }
+
+	//! Non throwing reads, returning False and reading nothing if not enough data.
+	inline Bool tryReadInt8(Int8 &value) { return tryRead(value, &NetBuffer::readInt8); }
+	inline Bool tryReadUInt8(UInt8 &value) { return tryRead(value, &NetBuffer::readUInt8); }
+	inline Bool tryReadInt16(Int16 &value) { return tryRead(value, &NetBuffer::readInt16); }
+	inline Bool tryReadUInt16(UInt16 &value) { return tryRead(value, &NetBuffer::readUInt16); }
+	inline Bool tryReadInt32(Int32 &value) { return tryRead(value, &NetBuffer::readInt32); }
+	inline Bool tryReadUInt32(UInt32 &value) { return tryRead(value, &NetBuffer::readUInt32); }
+	inline Bool tryReadInt64(Int64 &value) { return tryRead(value, &NetBuffer::readInt64); }
+	inline Bool tryReadUInt64(UInt64 &value) { return tryRead(value, &NetBuffer::readUInt64); }
+	inline Bool tryReadBool(Bool &value) { return tryRead(value, &NetBuffer::readBool); }
+
+	//! Non throwing read of a variable length integer, nothing is read if incomplete.
+	//! @exception E_BufferException if the varint is malformed.
+	Bool tryReadVarUInt32(UInt32 &value);
+	Bool tryReadVarUInt64(UInt64 &value);
+
 	//! Return how many byte can be read
 	virtual Int32 getAvailable() const = 0;
 
@@ -89,6 +291,44 @@ public:
 	//! return buffer
 	virtual UInt8* getBuffer() = 0;
 
+	//! Return the first contiguous readable region and its size in bytes.
+	//! @note For a segmented buffer the size can be lower than getAvailable().
+	virtual UInt8* getReadableSpan(UInt32 &size) = 0;
+
+	//! Return the first contiguous writable region and its size in bytes.
+	//! @note A growable buffer may allocate a new segment to satisfy the call.
+	virtual UInt8* getWritableSpan(UInt32 &size) = 0;
+
+	//! Fill up to max contiguous readable regions, in order.
+	//! @return The number of regions, 0 if nothing is readable.
+	//! @note The default returns the single region of getReadableSpan().
+	virtual UInt32 getReadableSegments(NetBufferSegment *segments, UInt32 max);
+
+	//! Fill up to max contiguous writable regions, in order.
+	//! @return The number of regions, 0 if the buffer is full.
+	//! @note A growable buffer may allocate the segments to satisfy the call.
+	virtual UInt32 getWritableSegments(NetBufferSegment *segments, UInt32 max);
+
+	//! Mark size bytes as read, after a bulk read from getReadableSpan().
+	virtual void skip(UInt32 size) = 0;
+
+	//! Mark size bytes as written, after a bulk write into getWritableSpan().
+	virtual void extend(UInt32 size) = 0;
+
+	//! Reserve size bytes at the write position, to be filled later with patch().
+	//! The bytes are zeroed.
+	//! @return A handle on the reserved bytes, valid until the next compact.
+	virtual UInt32 reserve(UInt32 size);
+
+	//! Overwrite size bytes previously reserved at handle.
+	virtual void patch(UInt32 handle, const UInt8 *data, UInt32 size) = 0;
+
+	//! Patch a reserved 16 bits integer, in the byte order of the buffer.
+	void patchUInt16(UInt32 handle, UInt16 value);
+
+	//! Patch a reserved 32 bits integer, in the byte order of the buffer.
+	void patchUInt32(UInt32 handle, UInt32 value);
+
 	//! optimize space inside buffer
 	virtual void compact() = 0;
 
@@ -100,6 +340,37 @@ public:
 
 	//! Get the byte order.
 	virtual System::ByteOrder getByteOrder() const = 0;
+
+protected:
+
+	UInt32 m_readMark;   //!< read position of the transaction
+
+	NetStringTable *m_stringTable;  //!< string table of the interned strings, not owned
+
+	Bool m_inFrame;                 //!< between beginFrame and its commit or rollback
+	std::vector<NetFrameListener*> m_frameListeners;
+
+	void writeVarInt(UInt64 value);
+	UInt64 readVarInt();
+
+	//! Read size bytes of an UTF-8 string into a view, the size being available.
+	void readUTF8Data(NetStringView &view, UInt32 size);
+
+	template <class T>
+	inline Bool tryRead(T &value, T (NetBuffer::*read)())
+	{
+		if ((UInt32)getAvailable() < sizeof(T))
+			return False;
+
+		value = (this->*read)();
+		return True;
+	}
+
+	//! Write count elements of elementSize bytes, span by span.
+	virtual void writeElements(const UInt8 *data, UInt32 count, UInt32 elementSize);
+
+	//! Read count elements of elementSize bytes, span by span.
+	virtual void readElements(UInt8 *data, UInt32 count, UInt32 elementSize);
 };
 
 //---------------------------------------------------------------------------------------
@@ -113,6 +384,8 @@ public:
 
 	ArrayNetBuffer(UInt8* array, UInt32 size);
 	ArrayNetBuffer(UInt32 size);
+	//! Wrap a block of the arena, given back at the destruction.
+	ArrayNetBuffer(NetBufferArena *arena);
 	virtual ~ArrayNetBuffer();
 
 	virtual void writeInt8(Int8 value);
@@ -163,6 +436,13 @@ public:
 	virtual UInt8* getWriteBuffer();
 	virtual UInt8* getBuffer();
 
+	virtual UInt8* getReadableSpan(UInt32 &size);
+	virtual UInt8* getWritableSpan(UInt32 &size);
+
+	virtual void skip(UInt32 size);
+	virtual void extend(UInt32 size);
+
+	virtual void patch(UInt32 handle, const UInt8 *data, UInt32 size);
 
 	virtual void compact();
 
@@ -174,16 +454,26 @@ public:
 	//! Get the byte order.
 	virtual System::ByteOrder getByteOrder() const;
 
+protected:
+
+	virtual void writeElements(const UInt8 *data, UInt32 count, UInt32 elementSize);
+	virtual void readElements(UInt8 *data, UInt32 count, UInt32 elementSize);
+
 private:
 
 	System::ByteOrder m_byteOrder; //!< buffer byte order for read and write
-	Bool m_swap;               //!< true mean swap byte order
 
 	Bool m_wrapped;            //!< Wrap a C array
+	NetBufferArena *m_arena;   //!< Owner of the wrapped array, or null
 	UInt32 m_size;             //!< array size
 	UInt8* m_array;            //!< An array
 	UInt32 m_readPosition;     //!< Current read position
 	UInt32 m_writePosition;    //!< Current write position
+
+	void writeUTF8(const Char* string, UInt32 length);
+
+	template <class T> inline void store(UInt8 *data, T value) const;
+	template <class T> inline T load(const UInt8 *data) const;
 };
 
 //! @class E_BufferException base class for Buffer Exception
@@ -0,0 +1,96 @@
+/**
+ * @file netbufferarena.h
+ * @brief Fixed-size buffer blocks carved out of huge pages.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETBUFFERARENA_H
+#define _O3D_NETBUFFERARENA_H
+
+#include "net.h"
+
+#include <o3d/core/base.h>
+#include <o3d/core/mutex.h>
+
+#include <vector>
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Fixed-size buffer blocks carved out of 2MB huge pages.
+ * @details With many sessions the I/O buffers are packed into a few huge pages
+ * instead of being scattered across the heap, so the TLB covers all of them.
+ * Chunks of CHUNK_SIZE bytes are mapped with MAP_HUGETLB when the system has
+ * reserved huge pages, else aligned on 2MB and advised for transparent huge pages,
+ * else (or on Windows without the lock memory privilege) mapped with normal pages.
+ * Released blocks are kept in a free list, and the chunks are only unmapped at the
+ * destruction of the arena, which must outlive every block.
+ * The arena is thread-safe.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetBufferArena
+{
+public:
+
+    //! Size in bytes of a chunk, a huge page.
+    static const UInt32 CHUNK_SIZE = 2*1024*1024;
+
+    /**
+     * @brief NetBufferArena
+     * @param blockSize Size in bytes of each block, a power of two up to CHUNK_SIZE.
+     * @param maxChunks Maximal number of chunks, 0 for unbounded.
+     */
+    NetBufferArena(UInt32 blockSize = 4096, UInt32 maxChunks = 0);
+
+    virtual ~NetBufferArena();
+
+    /**
+     * @brief Get a free block, mapping a new chunk if needed.
+     * @exception E_BufferOverflow if maxChunks are used.
+     */
+    UInt8* acquire();
+
+    //! Give back a block previously acquired from this arena.
+    void release(UInt8 *block);
+
+    //! Size in bytes of each block.
+    inline UInt32 getBlockSize() const { return m_blockSize; }
+
+    //! Number of chunks mapped.
+    UInt32 getNumChunks() const;
+
+    //! Number of chunks backed by huge pages (reserved or transparent).
+    UInt32 getNumHugeChunks() const;
+
+private:
+
+    struct Chunk
+    {
+        UInt8 *data;
+        UInt32 size;    //!< mapped size, can be larger than CHUNK_SIZE to align it
+        void *base;     //!< mapped address, data is aligned into
+        Bool huge;
+    };
+
+    UInt32 m_blockSize;
+    UInt32 m_maxChunks;
+
+    FastMutex m_mutex;
+
+    std::vector<Chunk> m_chunks;
+    std::vector<UInt8*> m_free;
+    UInt32 m_carved;    //!< bytes carved from the last chunk
+
+    static Chunk mapChunk();
+    static void unmapChunk(Chunk &chunk);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETBUFFERARENA_H
@@ -19,6 +19,7 @@
 #include "socket.h"
 #include "netmessagefactory.h"
 #include "netreadwriteadapter.h"
+#include "netstringtable.h"
 
 namespace o3d {
 
@@ -84,6 +85,29 @@ public:
 	//! delete the read/write adapter.
 	void deleteReadWriteAdapter();
 
+	/**
+	 * @brief Replace the default segmented read and write buffers.
+	 * @param readBuffer A valid buffer, owned by the client.
+	 * @param writeBuffer A valid buffer, owned by the client.
+	 * @note Must be called before connect.
+	 */
+	void setBuffers(NetBuffer *readBuffer, NetBuffer *writeBuffer);
+
+	/**
+	 * @brief Attach a string table to the read and to the write buffers, used by the
+	 * messages through NetBuffer::writeInternedUTF8 and NetBuffer::readInternedUTF8.
+	 * @param capacity Number of strings of each table, must match the server one.
+	 * @param maxLength Maximal length in bytes of an interned string.
+	 * @note Must be called before connect, and the server session must enable it too.
+	 */
+	void enableStringInterning(UInt32 capacity = 256, UInt32 maxLength = 256);
+
+	//! Get the string table of the received strings, or null.
+	inline NetStringTable* getReadStringTable() { return m_readStringTable; }
+
+	//! Get the string table of the sent strings, or null.
+	inline NetStringTable* getWriteStringTable() { return m_writeStringTable; }
+
 	//! get the address family.
     UInt32 getAf() const;
 
@@ -169,12 +193,15 @@ private:
 
 	Thread* m_thread; //!<
 
-	ArrayNetBuffer* m_readBuffer; //!<
-	ArrayNetBuffer* m_writeBuffer; //!<
+	NetBuffer* m_readBuffer; //!<
+	NetBuffer* m_writeBuffer; //!<
 
 	NetMessage* m_readPendingMessage; //!<
 	NetMessage* m_writePendingMessage; //!<
 
+	NetStringTable* m_readStringTable; //!< owned, null if interning is disabled
+	NetStringTable* m_writeStringTable; //!< owned, null if interning is disabled
+
 	PCQueue<NetMessage*>* m_outgoingList; //!<
 	PCQueue<NetMessage*>* m_incomingList; //!<
 
@@ -0,0 +1,536 @@
+/**
+ * @file netcodec.h
+ * @brief Compile-time byte order codec for the hot serialization paths.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETCODEC_H
+#define _O3D_NETCODEC_H
+
+#include "netbuffer.h"
+
+#include <cstring>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+// Native byte order known at compile time
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    #define O3D_NET_NATIVE_BIG_ENDIAN 1
+#else
+    #define O3D_NET_NATIVE_BIG_ENDIAN 0
+#endif
+
+namespace o3d {
+namespace net {
+
+inline UInt8 byteSwap(UInt8 value) { return value; }
+
+inline UInt16 byteSwap(UInt16 value)
+{
+#ifdef _MSC_VER
+    return _byteswap_ushort(value);
+#else
+    return __builtin_bswap16(value);
+#endif
+}
+
+inline UInt32 byteSwap(UInt32 value)
+{
+#ifdef _MSC_VER
+    return _byteswap_ulong(value);
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+
+inline UInt64 byteSwap(UInt64 value)
+{
+#ifdef _MSC_VER
+    return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+//! Copy count 16 bits elements from src to dst swapping their byte order (SIMD).
+O3D_NET_API void byteSwapArray16(UInt8 *dst, const UInt8 *src, UInt32 count);
+//! Copy count 32 bits elements from src to dst swapping their byte order (SIMD).
+O3D_NET_API void byteSwapArray32(UInt8 *dst, const UInt8 *src, UInt32 count);
+//! Copy count 64 bits elements from src to dst swapping their byte order (SIMD).
+O3D_NET_API void byteSwapArray64(UInt8 *dst, const UInt8 *src, UInt32 count);
+
+//! Copy count elements of elementSize (1, 2, 4 or 8) bytes, swapping their byte order if swap is true.
+O3D_NET_API void copyElements(UInt8 *dst, const UInt8 *src, UInt32 count, UInt32 elementSize, Bool swap);
+
+//! Index of the lowest set bit, value must not be zero.
+inline UInt32 countTrailingZeros64(UInt64 value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<UInt32>(index);
+#else
+    return static_cast<UInt32>(__builtin_ctzll(value));
+#endif
+}
+
+/**
+ * @brief Variable length integers (LEB128, 7 bits per byte, lowest group first) and
+ *        ZigZag mapping of signed integers (0, -1, 1, -2... to 0, 1, 2, 3...).
+ * @details A 32 bits value takes from 1 to 5 bytes, a 64 bits one from 1 to 10 bytes.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class NetVarInt
+{
+public:
+
+    static const UInt32 MAX_SIZE32 = 5;
+    static const UInt32 MAX_SIZE64 = 10;
+
+    static inline UInt32 zigZag32(Int32 value)
+    {
+        return (static_cast<UInt32>(value) << 1) ^ static_cast<UInt32>(value >> 31);
+    }
+
+    static inline UInt64 zigZag64(Int64 value)
+    {
+        return (static_cast<UInt64>(value) << 1) ^ static_cast<UInt64>(value >> 63);
+    }
+
+    static inline Int32 unZigZag32(UInt32 value)
+    {
+        return static_cast<Int32>((value >> 1) ^ (0u - (value & 1)));
+    }
+
+    static inline Int64 unZigZag64(UInt64 value)
+    {
+        return static_cast<Int64>((value >> 1) ^ (0ull - (value & 1)));
+    }
+
+    //! Encode into at least MAX_SIZE64 bytes, and return the number of bytes used.
+    static inline UInt32 encode(UInt8 *data, UInt64 value)
+    {
+        UInt32 len = 0;
+        while (value >= 0x80)
+        {
+            data[len++] = static_cast<UInt8>(value) | 0x80;
+            value >>= 7;
+        }
+
+        data[len++] = static_cast<UInt8>(value);
+        return len;
+    }
+
+    //! Encode on exactly size bytes (non minimal), for a value patched afterward.
+    static inline void encodePadded(UInt8 *data, UInt64 value, UInt32 size)
+    {
+        for (UInt32 i = 0; i + 1 < size; ++i)
+        {
+            data[i] = static_cast<UInt8>(value) | 0x80;
+            value >>= 7;
+        }
+
+        data[size - 1] = static_cast<UInt8>(value) & 0x7f;
+    }
+
+    /**
+     * @brief decodeFast Decode with no per byte branch.
+     * @param data At least MAX_SIZE64 readable bytes.
+     * @param value Decoded value.
+     * @return Number of bytes consumed, or 0 if the varint is malformed.
+     */
+    static inline UInt32 decodeFast(const UInt8 *data, UInt64 &value)
+    {
+        UInt64 word;
+        memcpy(&word, data, 8);
+#if O3D_NET_NATIVE_BIG_ENDIAN
+        word = byteSwap(word);
+#endif
+        // the continuation bits of the first 8 bytes, the lowest cleared one ends the varint
+        const UInt64 stop = ~word & 0x8080808080808080ull;
+
+        if (stop != 0)
+        {
+            // keep the bytes up to the stop bit, then pack the 7 bits groups
+            word &= (stop ^ (stop - 1)) & 0x7f7f7f7f7f7f7f7full;
+            value = pack(word);
+            return (countTrailingZeros64(stop) >> 3) + 1;
+        }
+
+        value = pack(word & 0x7f7f7f7f7f7f7f7full) | (static_cast<UInt64>(data[8] & 0x7f) << 56);
+        if (data[8] < 0x80)
+            return 9;
+
+        // only the highest bit remains
+        if (data[9] > 1)
+            return 0;
+
+        value |= static_cast<UInt64>(data[9]) << 63;
+        return 10;
+    }
+
+private:
+
+    //! Pack eight 7 bits groups (one per byte) into 56 contiguous bits.
+    static inline UInt64 pack(UInt64 word)
+    {
+        word = ((word & 0x7f007f007f007f00ull) >> 1) | (word & 0x007f007f007f007full);
+        word = ((word & 0x3fff00003fff0000ull) >> 2) | (word & 0x00003fff00003fffull);
+        word = ((word & 0x0fffffff00000000ull) >> 4) | (word & 0x000000000fffffffull);
+        return word;
+    }
+};
+
+/**
+ * @brief Load and store of unsigned integers in a byte order known at compile time.
+ * @details Use native (unaligned safe) loads and stores, plus a bswap when the order
+ * differs from the native one. The branch is resolved at compile time.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+template <System::ByteOrder ORDER>
+class NetByteOrderCodec
+{
+public:
+
+    static const Bool SWAP = (ORDER == System::ORDER_BIG_ENDIAN) != (O3D_NET_NATIVE_BIG_ENDIAN != 0);
+
+    template <class T>
+    static inline T load(const UInt8 *data)
+    {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return SWAP ? byteSwap(value) : value;
+    }
+
+    template <class T>
+    static inline void store(UInt8 *data, T value)
+    {
+        if (SWAP)
+            value = byteSwap(value);
+
+        memcpy(data, &value, sizeof(T));
+    }
+};
+
+typedef NetByteOrderCodec<System::ORDER_LITTLE_ENDIAN> LittleEndianCodec;
+typedef NetByteOrderCodec<System::ORDER_BIG_ENDIAN> BigEndianCodec;
+
+/**
+ * @brief Non virtual buffer codec over a contiguous array, with a compile-time byte order.
+ * @details It does not own the array. Every accessor is inlineable and costs a bounds
+ * check plus a native load or store (and a bswap for the foreign order).
+ * Use NetCodec::encode and NetCodec::decode to run it over a NetBuffer.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+template <System::ByteOrder ORDER>
+class BasicNetBuffer
+{
+public:
+
+    typedef NetByteOrderCodec<ORDER> Codec;
+
+    /**
+     * @brief BasicNetBuffer
+     * @param array Valid array.
+     * @param size Size of the array in bytes.
+     * @param limit Number of bytes already written (readable) into the array.
+     */
+    BasicNetBuffer(UInt8 *array, UInt32 size, UInt32 limit = 0) :
+        m_array(array),
+        m_size(size),
+        m_readPosition(0),
+        m_writePosition(limit)
+    {
+    }
+
+    inline void writeInt8(Int8 value) { put<UInt8>(static_cast<UInt8>(value)); }
+    inline void writeUInt8(UInt8 value) { put<UInt8>(value); }
+
+    inline void writeInt16(Int16 value) { put<UInt16>(static_cast<UInt16>(value)); }
+    inline void writeUInt16(UInt16 value) { put<UInt16>(value); }
+
+    inline void writeInt32(Int32 value) { put<UInt32>(static_cast<UInt32>(value)); }
+    inline void writeUInt32(UInt32 value) { put<UInt32>(value); }
+
+    inline void writeInt64(Int64 value) { put<UInt64>(static_cast<UInt64>(value)); }
+    inline void writeUInt64(UInt64 value) { put<UInt64>(value); }
+
+    inline void writeBool(Bool value) { put<UInt8>(value ? 1 : 0); }
+
+    inline void writeVarUInt32(UInt32 value) { putVarInt(value); }
+    inline void writeVarUInt64(UInt64 value) { putVarInt(value); }
+
+    inline void writeVarInt32(Int32 value) { putVarInt(NetVarInt::zigZag32(value)); }
+    inline void writeVarInt64(Int64 value) { putVarInt(NetVarInt::zigZag64(value)); }
+
+    inline void write(const UInt8 *buffer, UInt32 size)
+    {
+        if (size > m_size - m_writePosition)
+            O3D_ERROR(E_BufferOverflow("Write overflow"));
+
+        memcpy(m_array + m_writePosition, buffer, size);
+        m_writePosition += size;
+    }
+
+    inline Int8 readInt8() { return static_cast<Int8>(get<UInt8>()); }
+    inline UInt8 readUInt8() { return get<UInt8>(); }
+
+    inline Int16 readInt16() { return static_cast<Int16>(get<UInt16>()); }
+    inline UInt16 readUInt16() { return get<UInt16>(); }
+
+    inline Int32 readInt32() { return static_cast<Int32>(get<UInt32>()); }
+    inline UInt32 readUInt32() { return get<UInt32>(); }
+
+    inline Int64 readInt64() { return static_cast<Int64>(get<UInt64>()); }
+    inline UInt64 readUInt64() { return get<UInt64>(); }
+
+    inline Bool readBool() { return get<UInt8>() != 0; }
+
+    inline UInt32 readVarUInt32() { return narrowVarInt(getVarInt()); }
+    inline UInt64 readVarUInt64() { return getVarInt(); }
+
+    inline Int32 readVarInt32() { return NetVarInt::unZigZag32(narrowVarInt(getVarInt())); }
+    inline Int64 readVarInt64() { return NetVarInt::unZigZag64(getVarInt()); }
+
+    inline void read(UInt8 *buffer, UInt32 size)
+    {
+        if (size > m_writePosition - m_readPosition)
+            O3D_ERROR(E_BufferOverflow("Read overflow"));
+
+        memcpy(buffer, m_array + m_readPosition, size);
+        m_readPosition += size;
+    }
+
+    //! Return how many byte can be read
+    inline UInt32 getAvailable() const { return m_writePosition - m_readPosition; }
+    //! Return how many byte can be write
+    inline UInt32 getFree() const { return m_size - m_writePosition; }
+
+    //! Get the read position.
+    inline UInt32 getPosition() const { return m_readPosition; }
+    //! Get the write position.
+    inline UInt32 getLimit() const { return m_writePosition; }
+
+    inline UInt8* getBuffer() { return m_array; }
+
+private:
+
+    UInt8 *m_array;
+    UInt32 m_size;
+    UInt32 m_readPosition;
+    UInt32 m_writePosition;
+
+    template <class T>
+    inline void put(T value)
+    {
+        if (sizeof(T) > m_size - m_writePosition)
+            O3D_ERROR(E_BufferOverflow("Write overflow"));
+
+        Codec::template store<T>(m_array + m_writePosition, value);
+        m_writePosition += sizeof(T);
+    }
+
+    template <class T>
+    inline T get()
+    {
+        if (sizeof(T) > m_writePosition - m_readPosition)
+            O3D_ERROR(E_BufferOverflow("Read overflow"));
+
+        T value = Codec::template load<T>(m_array + m_readPosition);
+        m_readPosition += sizeof(T);
+        return value;
+    }
+
+    inline void putVarInt(UInt64 value)
+    {
+        if (m_size - m_writePosition >= NetVarInt::MAX_SIZE64)
+        {
+            m_writePosition += NetVarInt::encode(m_array + m_writePosition, value);
+        }
+        else
+        {
+            UInt8 data[NetVarInt::MAX_SIZE64];
+            write(data, NetVarInt::encode(data, value));
+        }
+    }
+
+    inline UInt64 getVarInt()
+    {
+        UInt64 value = 0;
+
+        if (m_writePosition - m_readPosition >= NetVarInt::MAX_SIZE64)
+        {
+            const UInt32 len = NetVarInt::decodeFast(m_array + m_readPosition, value);
+            if (len == 0)
+                O3D_ERROR(E_BufferException("Malformed varint"));
+
+            m_readPosition += len;
+            return value;
+        }
+
+        for (UInt32 shift = 0; shift < 64; shift += 7)
+        {
+            const UInt8 byte = get<UInt8>();
+            value |= static_cast<UInt64>(byte & 0x7f) << shift;
+
+            if (byte < 0x80)
+                return value;
+        }
+
+        O3D_ERROR(E_BufferException("Malformed varint"));
+    }
+
+    static inline UInt32 narrowVarInt(UInt64 value)
+    {
+        if (value > 0xffffffffull)
+            O3D_ERROR(E_BufferException("Malformed varint"));
+
+        return static_cast<UInt32>(value);
+    }
+};
+
+typedef BasicNetBuffer<System::ORDER_LITTLE_ENDIAN> LittleEndianNetBuffer;
+typedef BasicNetBuffer<System::ORDER_BIG_ENDIAN> BigEndianNetBuffer;
+
+/**
+ * @brief Run a serialization functor on a BasicNetBuffer over a NetBuffer.
+ * @details The functor must be generic, to accept both byte orders, for example
+ * a C++14 lambda taking an auto& parameter:
+ * @code
+ * NetCodec::encode(buffer, 12, [&](auto &out) {
+ *     out.writeInt32(m_x);
+ *     out.writeInt64(m_time);
+ * });
+ * @endcode
+ * This costs a few virtual calls per message instead of one per field.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class NetCodec
+{
+public:
+
+    /**
+     * @brief encode Serialize directly into the writable span of the buffer, or into
+     *        a temporary array appended to the buffer if the span is too small.
+     * @param buffer Destination buffer.
+     * @param maxSize Maximal number of bytes the functor can write.
+     * @param functor Generic functor taking a BasicNetBuffer.
+     */
+    template <class FUNCTOR>
+    static void encode(NetBuffer *buffer, UInt32 maxSize, FUNCTOR functor)
+    {
+        UInt32 size = 0;
+        UInt8 *data = buffer->getWritableSpan(size);
+
+        if (size >= maxSize)
+        {
+            buffer->extend(encodeInto(buffer->getByteOrder(), data, size, functor));
+        }
+        else
+        {
+            std::vector<UInt8> temp(maxSize);
+            const UInt32 len = encodeInto(buffer->getByteOrder(), temp.data(), maxSize, functor);
+
+            buffer->write(temp.data(), len);
+        }
+    }
+
+    /**
+     * @brief decode Deserialize directly from the readable span of the buffer, or from
+     *        a temporary copy when the data are not contiguous.
+     * @param buffer Source buffer.
+     * @param size Number of bytes the functor is going to read.
+     * @param functor Generic functor taking a BasicNetBuffer.
+     * @return False if less than size bytes are available, nothing is read then.
+     * @note Exactly size bytes are consumed, whatever the functor really reads, so
+     * the result does not depend on the contiguity of the data. The functor cannot
+     * read past size bytes.
+     */
+    template <class FUNCTOR>
+    static Bool decode(NetBuffer *buffer, UInt32 size, FUNCTOR functor)
+    {
+        if ((UInt32)buffer->getAvailable() < size)
+            return False;
+
+        UInt32 span = 0;
+        UInt8 *data = buffer->getReadableSpan(span);
+
+        if (span >= size)
+        {
+            decodeFrom(buffer->getByteOrder(), data, size, functor);
+            buffer->skip(size);
+        }
+        else
+        {
+            std::vector<UInt8> temp(size);
+            UInt8 *dst = temp.data();
+
+            // copy span by span, read() is limited to 16 bits sizes
+            UInt32 remaining = size;
+            while (remaining > 0)
+            {
+                data = buffer->getReadableSpan(span);
+                span = span < remaining ? span : remaining;
+
+                memcpy(dst, data, span);
+                buffer->skip(span);
+
+                dst += span;
+                remaining -= span;
+            }
+
+            decodeFrom(buffer->getByteOrder(), temp.data(), size, functor);
+        }
+
+        return True;
+    }
+
+private:
+
+    template <class FUNCTOR>
+    static UInt32 encodeInto(System::ByteOrder order, UInt8 *data, UInt32 size, FUNCTOR &functor)
+    {
+        if (order == System::ORDER_BIG_ENDIAN)
+        {
+            BigEndianNetBuffer out(data, size);
+            functor(out);
+            return out.getLimit();
+        }
+        else
+        {
+            LittleEndianNetBuffer out(data, size);
+            functor(out);
+            return out.getLimit();
+        }
+    }
+
+    template <class FUNCTOR>
+    static void decodeFrom(System::ByteOrder order, UInt8 *data, UInt32 size, FUNCTOR &functor)
+    {
+        if (order == System::ORDER_BIG_ENDIAN)
+        {
+            BigEndianNetBuffer in(data, size, size);
+            functor(in);
+        }
+        else
+        {
+            LittleEndianNetBuffer in(data, size, size);
+            functor(in);
+        }
+    }
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETCODEC_H
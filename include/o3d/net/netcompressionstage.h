@@ -0,0 +1,95 @@
+/**
+ * @file netcompressionstage.h
+ * @brief Streaming LZ4-like compression stage, with a per connection history.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETCOMPRESSIONSTAGE_H
+#define _O3D_NETCOMPRESSIONSTAGE_H
+
+#include "netadapterpipeline.h"
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Compression stage of a NetAdapterPipeline, with a streaming history.
+ * @details Frames are compressed with a fast LZ77 in the LZ4 block format (token,
+ * literals, 16 bits offset, match length), preceded by the frame size in a varint.
+ * Matches can reference the previous frames of the connection, in a sliding window,
+ * so repetitive state messages are mostly encoded as references to the former ones.
+ * Each direction keeps its own history, the encoder the frames it compressed and the
+ * decoder the frames it decompressed, in the same order.
+ * Frames smaller than the threshold, or that do not shrink, are passed through and
+ * stay out of the history.
+ * @note The history belongs to a single connection, so must be the pipeline, and a
+ * frame shared by several connections cannot be compressed once for all of them.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetCompressionStage : public NetAdapterStage
+{
+public:
+
+    //! Compression activity of the encoder.
+    struct Stats
+    {
+        UInt64 numFrames;        //!< frames given to encode
+        UInt64 numCompressed;    //!< frames compressed, the others are passed through
+        UInt64 bytesIn;          //!< size of all the frames
+        UInt64 bytesOut;         //!< size of all the frames once encoded or passed through
+    };
+
+    /**
+     * @brief NetCompressionStage
+     * @param minFrameSize Smaller frames are passed through.
+     * @param windowSize Size of the history referenced by the matches, up to 65535.
+     */
+    NetCompressionStage(UInt32 minFrameSize = 32, UInt32 windowSize = 16384);
+
+    virtual ~NetCompressionStage();
+
+    virtual Bool encode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out);
+    virtual void decode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out);
+
+    //! Get the compression activity.
+    inline const Stats& getStats() const { return m_stats; }
+
+    //! Ratio of the original size to the sent size, 1 if nothing was sent.
+    Float getRatio() const;
+
+private:
+
+    //! Sliding history of the frames of one direction.
+    struct History
+    {
+        std::vector<UInt8> data;
+        UInt32 size;
+
+        //! Make room for a frame, keeping at least the window, returns the shift.
+        UInt32 prepare(UInt32 frameSize, UInt32 window);
+    };
+
+    static const UInt32 HASH_BITS = 12;
+
+    UInt32 m_minFrameSize;
+    UInt32 m_window;
+
+    History m_encoder;
+    History m_decoder;
+
+    UInt32 m_encoderBase;    //!< absolute position of the encoder history, modulo 2^32
+    UInt32 *m_hashTable;     //!< last absolute position of each hashed 4 bytes
+
+    Stats m_stats;
+
+    UInt32 compress(UInt32 start, UInt32 end, UInt8 *out);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETCOMPRESSIONSTAGE_H
@@ -0,0 +1,870 @@
+/**
+ * @file netdeltasnapshot.h
+ * @brief Delta encoding of entity states against per-session baselines.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETDELTASNAPSHOT_H
+#define _O3D_NETDELTASNAPSHOT_H
+
+#include "netmessageschema.h"
+
+#include <o3d/core/mutex.h>
+
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Per-session delta encoding state, whatever the schema.
+ * @details Owned by a session (@see ProxyServerSession::setDeltaState), so that the
+ * acknowledgements received by the session can reach it.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetDeltaState
+{
+public:
+
+    enum Delivery
+    {
+        DELIVERY_ASSUMED = 0,   //!< Ordered and reliable stream (TCP), a written state is the baseline.
+        DELIVERY_ACKNOWLEDGED   //!< A state is the baseline once its snapshot is acknowledged.
+    };
+
+    //! Number of unacknowledged snapshots kept per entity, on both peers.
+    static const UInt32 WINDOW = 16;
+
+    struct Stats
+    {
+        UInt64 numSnapshots;    //!< snapshots written
+        UInt64 numUpdates;      //!< entities written
+        UInt64 numSkipped;      //!< entities unchanged, not written at all
+        UInt64 numFields;       //!< fields written
+    };
+
+    NetDeltaState(Delivery delivery, const void *schema) :
+        m_delivery(delivery),
+        m_schema(schema)
+    {
+        m_stats.numSnapshots = 0;
+        m_stats.numUpdates = 0;
+        m_stats.numSkipped = 0;
+        m_stats.numFields = 0;
+    }
+
+    virtual ~NetDeltaState() = 0;
+
+    inline Delivery getDelivery() const { return m_delivery; }
+
+    //! Identifier of the schema of the state (@see schemaId).
+    inline const void* getSchema() const { return m_schema; }
+
+    //! Unique identifier of a schema, without RTTI.
+    template <class SCHEMA>
+    static const void* schemaId()
+    {
+        static const Char id = 0;
+        return &id;
+    }
+
+    //! Acknowledge a snapshot sequence received by the peer.
+    //! @note Thread-safe, the baselines are advanced at the next snapshot.
+    virtual void acknowledge(UInt32 sequence) = 0;
+
+    //! Forget every baseline, must be done on both peers at the same time.
+    virtual void reset() = 0;
+
+    inline const Stats& getStats() const { return m_stats; }
+
+protected:
+
+    Delivery m_delivery;
+    const void *m_schema;
+    Stats m_stats;
+};
+
+/**
+ * @brief States of the entities of a tick, shared by the sessions.
+ * @details Built once per tick, then encoded by each session against its own
+ * baselines (@see ProxyServer::multicastDelta). Reference counted, the last session
+ * having written it deletes it.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+template <class SCHEMA>
+class O3D_NET_API_TEMPLATE NetDeltaSnapshot
+{
+public:
+
+    typedef typename SCHEMA::Data Data;
+    typedef std::pair<UInt32, Data> Entity;
+
+    NetDeltaSnapshot() :
+        m_refs(1)
+    {
+    }
+
+    //! Current state of an entity.
+    inline void update(UInt32 id, const Data &state) { m_entities.push_back(Entity(id, state)); }
+
+    //! Entity no longer existing.
+    inline void remove(UInt32 id) { m_removals.push_back(id); }
+
+    inline const std::vector<Entity>& getEntities() const { return m_entities; }
+    inline const std::vector<UInt32>& getRemovals() const { return m_removals; }
+
+    inline void retain() { m_refs.fetch_add(1, std::memory_order_relaxed); }
+
+    inline void release()
+    {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+private:
+
+    std::vector<Entity> m_entities;
+    std::vector<UInt32> m_removals;
+
+    std::atomic<UInt32> m_refs;
+
+    ~NetDeltaSnapshot() {}
+};
+
+/**
+ * @brief Sending side of the delta encoding, one per session and per schema.
+ * @details A snapshot is a varint sequence, then an entry per entity, then a 0:
+ * - an update is the varint 2*id+1, [the varint distance to the baseline sequence,
+ *   0 for none, when acknowledged], the varint change mask, then the changed fields
+ *   packed in their schema order,
+ * - a removal is the varint 2*id+2.
+ * An entity without a baseline is encoded against a zeroed state. An entity that did
+ * not change since its baseline is not written at all, so the size of a snapshot
+ * follows the change rate rather than the number of entities.
+ * With DELIVERY_ASSUMED a written state becomes the baseline once the adapter commits
+ * the frame of the snapshot, a dropped frame leaves the baselines as they were. Both
+ * peers stay in sync as long as the stream is ordered and reliable.
+ * With DELIVERY_ACKNOWLEDGED the baseline of an entity is its last state whose
+ * snapshot has been acknowledged, and a removal is repeated until acknowledged.
+ * The peer must acknowledge within WINDOW updates of an entity, else the entity is
+ * sent against a zeroed state until the next acknowledgement.
+ * @note A snapshot is written by a single message, so it must fit a message size.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+template <class SCHEMA>
+class O3D_NET_API_TEMPLATE NetDeltaEncoder : public NetDeltaState, public NetFrameListener
+{
+public:
+
+    typedef typename SCHEMA::Data Data;
+
+    NetDeltaEncoder(Delivery delivery = DELIVERY_ASSUMED) :
+        NetDeltaState(delivery, schemaId<SCHEMA>()),
+        m_sequence(0),
+        m_sent(delivery == DELIVERY_ACKNOWLEDGED ? WINDOW : 0)
+    {
+    }
+
+    virtual ~NetDeltaEncoder() {}
+
+    //! Checked downcast, null if the state is null or uses another schema.
+    static NetDeltaEncoder<SCHEMA>* cast(NetDeltaState *state)
+    {
+        if ((state == nullptr) || (state->getSchema() != schemaId<SCHEMA>()))
+            return nullptr;
+
+        return static_cast<NetDeltaEncoder<SCHEMA>*>(state);
+    }
+
+    //! Start a snapshot, write its sequence.
+    void beginSnapshot(NetBuffer *buffer)
+    {
+        applyAcknowledgements();
+
+        // left by a snapshot interrupted by an exception
+        m_staged.clear();
+
+        ++m_sequence;
+        buffer->writeVarUInt32(m_sequence);
+
+        if (m_delivery == DELIVERY_ACKNOWLEDGED)
+        {
+            Sent &sent = m_sent[m_sequence % WINDOW];
+            sent.sequence = m_sequence;
+            sent.updated.clear();
+            sent.removed.clear();
+        }
+
+        ++m_stats.numSnapshots;
+    }
+
+    /**
+     * @brief writeEntity Write the changed fields of an entity.
+     * @return False if the entity did not change since its baseline, nothing is
+     * written then.
+     */
+    Bool writeEntity(NetBuffer *buffer, UInt32 id, const Data &state)
+    {
+        const Data zero = Data();
+
+        UInt32 mask;
+        UInt32 distance = 0;
+
+        if (m_delivery == DELIVERY_ASSUMED)
+        {
+            // the baseline as of the previous entries of the snapshot
+            const Data *baseline = nullptr;
+
+            auto staged = m_staged.find(id);
+            if (staged != m_staged.end())
+            {
+                baseline = staged->second.removed ? nullptr : &staged->second.state;
+            }
+            else
+            {
+                auto it = m_entities.find(id);
+                if ((it != m_entities.end()) && it->second.known)
+                    baseline = &it->second.state;
+            }
+
+            mask = SCHEMA::changeMask(state, baseline != nullptr ? *baseline : zero);
+
+            if ((baseline != nullptr) && (mask == 0))
+            {
+                ++m_stats.numSkipped;
+                return False;
+            }
+
+            // applied once the frame is committed
+            Staged &change = m_staged[id];
+            change.state = state;
+            change.removed = False;
+        }
+        else
+        {
+            Entity &entity = m_entities[id];
+
+            m_removing.erase(id);
+
+            // the peer keeps WINDOW states, the baseline must be one of them
+            if (entity.pending.size() >= WINDOW)
+                entity.known = False;
+
+            mask = SCHEMA::changeMask(state, entity.known ? entity.state : zero);
+
+            if (entity.known)
+            {
+                if ((mask == 0) && entity.pending.empty())
+                {
+                    ++m_stats.numSkipped;
+                    return False;
+                }
+
+                distance = m_sequence - entity.sequence;
+            }
+
+            if (entity.pending.size() >= WINDOW)
+                entity.pending.erase(entity.pending.begin());
+
+            entity.pending.push_back(Pending(m_sequence, state));
+            m_sent[m_sequence % WINDOW].updated.push_back(id);
+        }
+
+        buffer->writeVarUInt64((static_cast<UInt64>(id) << 1) + 1);
+
+        if (m_delivery == DELIVERY_ACKNOWLEDGED)
+            buffer->writeVarUInt32(distance);
+
+        buffer->writeVarUInt32(mask);
+        SCHEMA::writeMasked(buffer, state, mask);
+
+        ++m_stats.numUpdates;
+        m_stats.numFields += countBits(mask);
+
+        return True;
+    }
+
+    //! Write the removal of an entity, and forget its baseline.
+    void writeRemoval(NetBuffer *buffer, UInt32 id)
+    {
+        if (m_delivery == DELIVERY_ACKNOWLEDGED)
+        {
+            m_entities.erase(id);
+
+            // repeated by the next snapshots until acknowledged
+            m_removing[id] = m_sequence;
+            return;
+        }
+
+        // applied once the frame is committed
+        m_staged[id].removed = True;
+
+        buffer->writeVarUInt64((static_cast<UInt64>(id) << 1) + 2);
+    }
+
+    //! Finish the snapshot.
+    void endSnapshot(NetBuffer *buffer)
+    {
+        if (m_delivery == DELIVERY_ACKNOWLEDGED)
+        {
+            Sent &sent = m_sent[m_sequence % WINDOW];
+
+            for (const std::pair<const UInt32, UInt32> &removal : m_removing)
+            {
+                buffer->writeVarUInt64((static_cast<UInt64>(removal.first) << 1) + 2);
+                sent.removed.push_back(removal.first);
+            }
+        }
+
+        buffer->writeVarUInt32(0);
+
+        if (m_delivery == DELIVERY_ASSUMED)
+            buffer->addFrameListener(this);
+    }
+
+    //! Write a whole shared snapshot.
+    void writeSnapshot(NetBuffer *buffer, const NetDeltaSnapshot<SCHEMA> &snapshot)
+    {
+        beginSnapshot(buffer);
+
+        for (const typename NetDeltaSnapshot<SCHEMA>::Entity &entity : snapshot.getEntities())
+        {
+            writeEntity(buffer, entity.first, entity.second);
+        }
+
+        for (UInt32 id : snapshot.getRemovals())
+        {
+            writeRemoval(buffer, id);
+        }
+
+        endSnapshot(buffer);
+    }
+
+    virtual void acknowledge(UInt32 sequence)
+    {
+        if (m_delivery != DELIVERY_ACKNOWLEDGED)
+            return;
+
+        FastMutexLocker locker(m_ackMutex);
+        m_acks.push_back(sequence);
+    }
+
+    //! Apply the baselines of the snapshot.
+    virtual void frameCommitted()
+    {
+        for (const std::pair<const UInt32, Staged> &change : m_staged)
+        {
+            if (change.second.removed)
+            {
+                m_entities.erase(change.first);
+            }
+            else
+            {
+                Entity &entity = m_entities[change.first];
+                entity.state = change.second.state;
+                entity.known = True;
+            }
+        }
+
+        m_staged.clear();
+    }
+
+    //! Discard the baselines of the snapshot, the peer never receives it.
+    virtual void frameDropped()
+    {
+        m_staged.clear();
+    }
+
+    virtual void reset()
+    {
+        m_entities.clear();
+        m_staged.clear();
+        m_removing.clear();
+
+        for (Sent &sent : m_sent)
+        {
+            sent.sequence = 0;
+            sent.updated.clear();
+            sent.removed.clear();
+        }
+
+        FastMutexLocker locker(m_ackMutex);
+        m_acks.clear();
+    }
+
+    //! Sequence of the last snapshot written.
+    inline UInt32 getSequence() const { return m_sequence; }
+
+    //! Number of entities having a baseline or a pending state.
+    inline UInt32 getNumEntities() const { return (UInt32)m_entities.size(); }
+
+private:
+
+    typedef std::pair<UInt32, Data> Pending;
+
+    struct Entity
+    {
+        Entity() : state(), known(False), sequence(0) {}
+
+        Data state;         //!< baseline
+        Bool known;         //!< true if the baseline is known by the peer
+        UInt32 sequence;    //!< snapshot of the baseline, when acknowledged
+
+        std::vector<Pending> pending;   //!< states written but not yet acknowledged
+    };
+
+    struct Staged
+    {
+        Staged() : state(), removed(False) {}
+
+        Data state;
+        Bool removed;
+    };
+
+    struct Sent
+    {
+        Sent() : sequence(0) {}
+
+        UInt32 sequence;
+        std::vector<UInt32> updated;
+        std::vector<UInt32> removed;
+    };
+
+    UInt32 m_sequence;
+
+    std::unordered_map<UInt32, Entity> m_entities;
+    std::unordered_map<UInt32, Staged> m_staged;    //!< baselines of the snapshot being written
+    std::unordered_map<UInt32, UInt32> m_removing;  //!< removal sequence per entity
+    std::vector<Sent> m_sent;                       //!< last WINDOW snapshots
+
+    FastMutex m_ackMutex;
+    std::vector<UInt32> m_acks;                     //!< received since the last snapshot
+    std::vector<UInt32> m_applying;
+
+    static inline UInt32 countBits(UInt32 mask)
+    {
+        UInt32 n = 0;
+        for (; mask != 0; mask &= mask - 1)
+        {
+            ++n;
+        }
+
+        return n;
+    }
+
+    void applyAcknowledgements()
+    {
+        if (m_delivery != DELIVERY_ACKNOWLEDGED)
+            return;
+
+        {
+            FastMutexLocker locker(m_ackMutex);
+            m_applying.swap(m_acks);
+        }
+
+        for (UInt32 sequence : m_applying)
+        {
+            Sent &sent = m_sent[sequence % WINDOW];
+            if ((sent.sequence != sequence) || (sequence == 0))
+                continue;   // too old
+
+            for (UInt32 id : sent.updated)
+            {
+                auto it = m_entities.find(id);
+                if (it == m_entities.end())
+                    continue;
+
+                Entity &entity = it->second;
+                if (entity.known && (entity.sequence >= sequence))
+                    continue;
+
+                for (size_t i = 0; i < entity.pending.size(); ++i)
+                {
+                    if (entity.pending[i].first == sequence)
+                    {
+                        entity.state = entity.pending[i].second;
+                        entity.sequence = sequence;
+                        entity.known = True;
+
+                        entity.pending.erase(entity.pending.begin(), entity.pending.begin() + i + 1);
+                        break;
+                    }
+                }
+            }
+
+            for (UInt32 id : sent.removed)
+            {
+                auto it = m_removing.find(id);
+                if ((it != m_removing.end()) && (it->second <= sequence))
+                    m_removing.erase(it);
+            }
+
+            sent.sequence = 0;
+        }
+
+        m_applying.clear();
+    }
+};
+
+/**
+ * @brief Receiving side of the delta encoding, one per connection and per schema.
+ * @details Keeps the last state of each entity, and with DELIVERY_ACKNOWLEDGED the
+ * last WINDOW ones, the sender encoding against any of them. The sequence of the
+ * last snapshot read is the one to acknowledge.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+template <class SCHEMA>
+class O3D_NET_API_TEMPLATE NetDeltaDecoder
+{
+public:
+
+    typedef typename SCHEMA::Data Data;
+
+    enum Result
+    {
+        ENTITY_END = 0,     //!< end of the snapshot
+        ENTITY_UPDATED,     //!< state of an entity changed
+        ENTITY_REMOVED      //!< entity removed
+    };
+
+    NetDeltaDecoder(NetDeltaState::Delivery delivery = NetDeltaState::DELIVERY_ASSUMED) :
+        m_delivery(delivery),
+        m_sequence(0)
+    {
+    }
+
+    //! Start reading a snapshot, and return its sequence.
+    UInt32 beginSnapshot(NetBuffer *buffer)
+    {
+        m_sequence = buffer->readVarUInt32();
+        return m_sequence;
+    }
+
+    /**
+     * @brief readEntity Read the next entry of the snapshot.
+     * @param id Identifier of the entity, for ENTITY_UPDATED and ENTITY_REMOVED.
+     * @param state New state of the entity, for ENTITY_UPDATED.
+     * @exception E_BufferException if the baseline or the mask is invalid.
+     */
+    Result readEntity(NetBuffer *buffer, UInt32 &id, Data &state)
+    {
+        for (;;)
+        {
+            const UInt64 tag = buffer->readVarUInt64();
+            if (tag == 0)
+                return ENTITY_END;
+
+            if (((tag - 1) >> 1) > 0xffffffffull)
+            {
+                O3D_ERROR(E_BufferException("Invalid delta entity"));
+            }
+
+            id = static_cast<UInt32>((tag - 1) >> 1);
+
+            if (((tag - 1) & 1) != 0)
+            {
+                // a repeated removal of an unknown entity is ignored
+                if (m_entities.erase(id) > 0)
+                    return ENTITY_REMOVED;
+
+                continue;
+            }
+
+            Entity &entity = m_entities[id];
+            state = Data();
+
+            if (m_delivery == NetDeltaState::DELIVERY_ASSUMED)
+            {
+                state = entity.state;
+            }
+            else
+            {
+                const UInt32 distance = buffer->readVarUInt32();
+                if (distance > 0)
+                {
+                    const Data *baseline = entity.find(m_sequence - distance);
+                    if (baseline == nullptr)
+                    {
+                        O3D_ERROR(E_BufferException("Unknown delta baseline"));
+                    }
+
+                    state = *baseline;
+                }
+            }
+
+            const UInt32 mask = buffer->readVarUInt32();
+            if ((SCHEMA::NUM_FIELDS < 32) && ((mask >> SCHEMA::NUM_FIELDS) != 0))
+            {
+                O3D_ERROR(E_BufferException("Invalid delta mask"));
+            }
+
+            if (!SCHEMA::readMasked(buffer, state, mask))
+            {
+                O3D_ERROR(E_BufferOverflow("Read overflow"));
+            }
+
+            entity.state = state;
+
+            if (m_delivery == NetDeltaState::DELIVERY_ACKNOWLEDGED)
+            {
+                if (entity.history.size() >= NetDeltaState::WINDOW)
+                    entity.history.erase(entity.history.begin());
+
+                entity.history.push_back(std::pair<UInt32, Data>(m_sequence, state));
+            }
+
+            return ENTITY_UPDATED;
+        }
+    }
+
+    /**
+     * @brief readSnapshot Read a whole snapshot.
+     * @param updated If not null, receives the identifiers of the updated entities.
+     * @param removed If not null, receives the identifiers of the removed entities.
+     * @return The sequence of the snapshot, to acknowledge.
+     */
+    UInt32 readSnapshot(
+            NetBuffer *buffer,
+            std::vector<UInt32> *updated = nullptr,
+            std::vector<UInt32> *removed = nullptr)
+    {
+        beginSnapshot(buffer);
+
+        UInt32 id = 0;
+        Data state;
+        Result result;
+
+        while ((result = readEntity(buffer, id, state)) != ENTITY_END)
+        {
+            if ((result == ENTITY_UPDATED) && (updated != nullptr))
+                updated->push_back(id);
+            else if ((result == ENTITY_REMOVED) && (removed != nullptr))
+                removed->push_back(id);
+        }
+
+        return m_sequence;
+    }
+
+    //! Last state of an entity, or null if unknown.
+    inline const Data* get(UInt32 id) const
+    {
+        auto it = m_entities.find(id);
+        return it != m_entities.end() ? &it->second.state : nullptr;
+    }
+
+    //! Sequence of the last snapshot read.
+    inline UInt32 getSequence() const { return m_sequence; }
+
+    //! Number of known entities.
+    inline UInt32 getNumEntities() const { return (UInt32)m_entities.size(); }
+
+    //! Forget every entity, must be done on both peers at the same time.
+    void reset()
+    {
+        m_entities.clear();
+        m_sequence = 0;
+    }
+
+private:
+
+    struct Entity
+    {
+        Entity() : state() {}
+
+        Data state;
+        std::vector<std::pair<UInt32, Data>> history;   //!< last WINDOW states
+
+        const Data* find(UInt32 sequence) const
+        {
+            for (const std::pair<UInt32, Data> &entry : history)
+            {
+                if (entry.first == sequence)
+                    return &entry.second;
+            }
+
+            return nullptr;
+        }
+    };
+
+    NetDeltaState::Delivery m_delivery;
+    UInt32 m_sequence;
+
+    std::unordered_map<UInt32, Entity> m_entities;
+};
+
+/**
+ * @brief Outgoing message of a shared snapshot, encoded against the baselines of the
+ * session it is sent to.
+ * @details Encoded by the write thread of the session, the encoder must not be used
+ * concurrently apart from acknowledge().
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+template <UInt32 CODE, class SCHEMA>
+class O3D_NET_API_TEMPLATE NetDeltaSnapshotOut : public NetMessageOutHelper<CODE>
+{
+public:
+
+    //! The snapshot is retained, the encoder must outlive the message.
+    NetDeltaSnapshotOut(NetDeltaSnapshot<SCHEMA> *snapshot, NetDeltaEncoder<SCHEMA> *encoder) :
+        m_snapshot(snapshot),
+        m_encoder(encoder)
+    {
+        m_snapshot->retain();
+    }
+
+    virtual ~NetDeltaSnapshotOut()
+    {
+        m_snapshot->release();
+    }
+
+    virtual NetMessage* writeToBuffer(NetBuffer* buffer)
+    {
+        m_encoder->writeSnapshot(buffer, *m_snapshot);
+        return nullptr;
+    }
+
+private:
+
+    NetDeltaSnapshot<SCHEMA> *m_snapshot;
+    NetDeltaEncoder<SCHEMA> *m_encoder;
+};
+
+/**
+ * @brief Incoming message of a snapshot, kept encoded until decode() is called with
+ * the decoder of the connection, typically from run().
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+template <class CLASS, UInt32 CODE, class SCHEMA>
+class O3D_NET_API_TEMPLATE NetDeltaSnapshotIn : public NetMessageInHelper<CLASS, CODE>
+{
+public:
+
+    NetDeltaSnapshotIn() :
+        m_byteOrder(System::getNativeByteOrder())
+    {
+    }
+
+    virtual NetMessage* readFromBuffer(NetBuffer* buffer)
+    {
+        m_byteOrder = buffer->getByteOrder();
+        m_data.resize(this->m_messageDataSize);
+
+        // the whole message is available, copy it span by span
+        UInt32 received = 0;
+        while (received < (UInt32)m_data.size())
+        {
+            UInt32 size = 0;
+            const UInt8 *span = buffer->getReadableSpan(size);
+
+            if (size == 0)
+                O3D_ERROR(E_BufferOverflow("Read overflow"));
+
+            if (size > (UInt32)m_data.size() - received)
+                size = (UInt32)m_data.size() - received;
+
+            memcpy(m_data.data() + received, span, size);
+            buffer->skip(size);
+
+            received += size;
+        }
+
+        return nullptr;
+    }
+
+    //! Decode the snapshot, @see NetDeltaDecoder::readSnapshot.
+    UInt32 decode(
+            NetDeltaDecoder<SCHEMA> &decoder,
+            std::vector<UInt32> *updated = nullptr,
+            std::vector<UInt32> *removed = nullptr)
+    {
+        static UInt8 empty = 0;
+
+        ArrayNetBuffer buffer(m_data.empty() ? &empty : m_data.data(), (UInt32)m_data.size());
+        buffer.setByteOrder(m_byteOrder);
+        buffer.setLimit((UInt32)m_data.size());
+
+        return decoder.readSnapshot(&buffer, updated, removed);
+    }
+
+    virtual void recycle()
+    {
+        NetMessageInHelper<CLASS, CODE>::recycle();
+        m_data.clear();
+    }
+
+protected:
+
+    System::ByteOrder m_byteOrder;
+    std::vector<UInt8> m_data;
+};
+
+/**
+ * @brief Outgoing acknowledgement of a snapshot, sent back by the receiving side
+ * with DELIVERY_ACKNOWLEDGED.
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+template <UInt32 CODE>
+class O3D_NET_API_TEMPLATE NetDeltaAckOut : public NetMessageOutHelper<CODE>
+{
+public:
+
+    NetDeltaAckOut(UInt32 sequence) :
+        m_sequence(sequence)
+    {
+    }
+
+    virtual NetMessage* writeToBuffer(NetBuffer* buffer)
+    {
+        buffer->writeVarUInt32(m_sequence);
+        return nullptr;
+    }
+
+private:
+
+    UInt32 m_sequence;
+};
+
+/**
+ * @brief Incoming acknowledgement of a snapshot, to give to NetDeltaState::acknowledge.
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+template <class CLASS, UInt32 CODE>
+class O3D_NET_API_TEMPLATE NetDeltaAckIn : public NetMessageInHelper<CLASS, CODE>
+{
+public:
+
+    NetDeltaAckIn() :
+        m_sequence(0)
+    {
+    }
+
+    virtual NetMessage* readFromBuffer(NetBuffer* buffer)
+    {
+        m_sequence = buffer->readVarUInt32();
+        return nullptr;
+    }
+
+    inline UInt32 getSequence() const { return m_sequence; }
+
+protected:
+
+    UInt32 m_sequence;
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETDELTASNAPSHOT_H
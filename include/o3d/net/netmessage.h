@@ -70,6 +70,22 @@ public:
     {
         return True;
 	}
+
+    /** True if writeToBuffer writes the message with its framing, the read/write
+     * adapter of the session is then bypassed. Default returns false.
+     */
+    virtual Bool isFramed() const
+    {
+        return False;
+    }
+
+    /** Called in place of a delete once the message is consumed, or discarded.
+     * Default deletes the message, a pooled message goes back to its pool.
+     */
+    virtual void release()
+    {
+        delete this;
+    }
 };
 
 } // namespace net
@@ -16,6 +16,9 @@
 namespace o3d {
 namespace net {
 
+class NetMessagePool;
+class AbstractNetMessageStreamIn;
+
 /**
  * @brief Abstract message class
  * @date 2013-07-21
@@ -33,8 +36,8 @@ public:
 
     virtual UInt32 getMessageCode() const = 0;
 
-    virtual UInt16 getMessageSize() const;
-    virtual void setMessageSize(UInt16 dataSize);
+    virtual UInt32 getMessageSize() const;
+    virtual void setMessageSize(UInt32 dataSize);
 
     virtual String getDump() const;
 
@@ -61,7 +64,7 @@ public:
 
 protected:
 
-    UInt16 m_messageDataSize;
+    UInt32 m_messageDataSize;
     UInt32 m_consume;
 };
 
@@ -72,12 +75,35 @@ protected:
  */
 class O3D_NET_API AbstractNetMessageIn : public AbstractNetMessage
 {
+    friend class NetMessagePool;
+
 public:
 
+    AbstractNetMessageIn() :
+        m_pool(nullptr),
+        m_poolSlot(0xffffffff)
+    {
+    }
+
     virtual NetMessage* writeToBuffer(NetBuffer* buffer);
 
     //! Make an instance of the message.
     virtual AbstractNetMessageIn* makeInstance() const = 0;
+
+    //! Give back the message to its pool, or delete it.
+    virtual void release();
+
+    //! Reset the message before it is reused from a pool. Overrides must reset the
+    //! members that readFromBuffer does not always set, and call this one.
+    virtual void recycle();
+
+    //! The message if it accepts its payload by chunks, else null (no RTTI needed).
+    virtual AbstractNetMessageStreamIn* asStreamIn() { return nullptr; }
+
+private:
+
+    NetMessagePool *m_pool;   //!< pool the message comes from, or null
+    UInt32 m_poolSlot;        //!< free list of the message type in the pool
 };
 
 /**
@@ -123,7 +149,12 @@ public:
 /**
  * @brief Default read/write net message adapter.
  * It use of a multi-byte message code from 1 to 4 bytes, and manage the message size
- * in a 16 bits integer. It can be used with the DefaultNetMessageFactory.
+ * in a 16 bits integer, or optionally in a varint of 1 to 3 bytes (1 byte for messages
+ * lesser than 128 bytes). Both peers must use the same size framing.
+ * The size slot is reserved before the message is serialized and patched after, so
+ * outgoing messages have no need to compute their size. In varint mode a message that
+ * declares its size still gets a minimal varint, else a 3 bytes one.
+ * It can be used with the DefaultNetMessageFactory.
  * @date 2013-07-21
  * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
  */
@@ -131,11 +162,28 @@ class O3D_NET_API DefaultNetMessageAdapter : public NetReadWriteAdapter
 {
 public:
 
-    DefaultNetMessageAdapter();
+    /**
+     * @brief DefaultNetMessageAdapter
+     * @param varIntSize Frame the message size as a varint instead of a 16 bits integer.
+     */
+    DefaultNetMessageAdapter(Bool varIntSize = False);
     virtual ~DefaultNetMessageAdapter();
 
     virtual NetMessage* readFrom(NetBuffer* buffer, NetMessage* message);
     virtual NetMessage* writeTo(NetBuffer* buffer, NetMessage* message);
+
+    //! True if the message size is framed as a varint.
+    inline Bool isVarIntSize() const { return m_varIntSize; }
+
+    //! Largest message code, on 21 bits.
+    static const UInt32 MAX_MESSAGE_CODE = 0x1FFFFF;
+
+    //! Write a multi-byte message code of 1 to 4 bytes (like for UTF8).
+    static void writeMessageCode(NetBuffer *buffer, UInt32 code);
+
+private:
+
+    Bool m_varIntSize;
 };
 
 } // namespace net
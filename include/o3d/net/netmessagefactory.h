@@ -29,7 +29,8 @@ public:
     /**
      * @brief buildFromBuffer Build a message from buffer
      * @param buffer
-     * @return a message instance
+     * @return a message instance, or nullptr if the message header is incomplete
+     *         (the caller then rollbacks the read position and waits for more data)
      * @remark Use NetBuffer to uncouple networking api from message api
      *         Message will be fully initialized by invoking readFromBuffer
      */
@@ -0,0 +1,76 @@
+/**
+ * @file netmessageframe.h
+ * @brief Message encoded once, shared by several sessions.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETMESSAGEFRAME_H
+#define _O3D_NETMESSAGEFRAME_H
+
+#include "netmessage.h"
+
+#include <atomic>
+
+namespace o3d {
+namespace net {
+
+class NetReadWriteAdapter;
+
+/**
+ * @brief Immutable frame of an encoded message, shared by several sessions.
+ * @details The message is serialized once, with the framing of the adapter, and each
+ * session only copies the bytes into its write buffer, bypassing its own adapter.
+ * The frame is reference counted, consume() is thread-safe and returns true once every
+ * session has written it, so it is released by the last one.
+ * The sessions must use the same adapter framing and byte order than the frame.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetMessageFrame : public NetMessage
+{
+public:
+
+    /**
+     * @brief NetMessageFrame Encode a message.
+     * @param message Message to encode, it is not released.
+     * @param adapter Adapter used for the framing, or null for none.
+     * @param refs Number of sessions the frame is sent to.
+     * @exception E_InvalidParameter if the adapter is not shareable.
+     */
+    NetMessageFrame(NetMessage *message, NetReadWriteAdapter *adapter, UInt32 refs);
+
+    virtual ~NetMessageFrame();
+
+    //! Nothing to read, a frame is only outgoing.
+    virtual NetMessage* readFromBuffer(NetBuffer* buffer);
+
+    //! Copy the frame, or return this if the buffer has not enough free space.
+    virtual NetMessage* writeToBuffer(NetBuffer* buffer);
+
+    //! Always true, the frame contains its framing.
+    virtual Bool isFramed() const;
+
+    //! Decrement the reference counter, true when it reaches zero.
+    virtual Bool consume();
+
+    //! Encoded bytes.
+    inline const UInt8* getData() const { return m_data; }
+
+    //! Size in bytes of the frame.
+    inline UInt32 getSize() const { return m_size; }
+
+private:
+
+    UInt8 *m_data;
+    UInt32 m_size;
+
+    std::atomic<UInt32> m_refs;
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETMESSAGEFRAME_H
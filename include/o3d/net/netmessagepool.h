@@ -0,0 +1,93 @@
+/**
+ * @file netmessagepool.h
+ * @brief Per message code free lists of incoming messages.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETMESSAGEPOOL_H
+#define _O3D_NETMESSAGEPOOL_H
+
+#include "net.h"
+
+#include <o3d/core/base.h>
+#include <o3d/core/mutex.h>
+
+#include <atomic>
+#include <vector>
+
+namespace o3d {
+namespace net {
+
+class AbstractNetMessageIn;
+
+/**
+ * @brief Per message code free lists of incoming messages.
+ * @details A message built by acquire() is given back by its release(), in place
+ * of being deleted after its consume(), and is recycled by the next acquire of the
+ * same message code.
+ * Each thread keeps a small cache per message code, without lock, in front of the
+ * shared free lists, which receive the overflow by batches. A thread that builds
+ * messages and another that consumes them exchange them through the shared lists.
+ * Cached messages are deleted at the thread exit. The pool must outlive the messages
+ * it builds.
+ * Each registered prototype gets a free list slot, so the lookups are simple
+ * indexes whatever the message codes.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetMessagePool
+{
+public:
+
+    //! Activity of the pool.
+    struct Stats
+    {
+        UInt64 numAcquires;     //!< total number of acquire
+        UInt64 numAllocations;  //!< acquires that allocated a new message
+        UInt32 numFree;         //!< messages in the shared free lists
+    };
+
+    //! Maximum number of messages cached per thread and per message code.
+    static const UInt32 THREAD_CACHE_SIZE = 32;
+
+    /**
+     * @brief NetMessagePool
+     * @param maxFree Maximum number of free messages kept per message code.
+     */
+    NetMessagePool(UInt32 maxFree = 1024);
+
+    virtual ~NetMessagePool();
+
+    //! Assign a free list to a registered prototype, before any acquire of it.
+    void registerPrototype(AbstractNetMessageIn *prototype);
+
+    //! Get a recycled message of the type of the prototype, or make a new instance.
+    AbstractNetMessageIn* acquire(const AbstractNetMessageIn *prototype);
+
+    //! Give back a message previously acquired from this pool.
+    void release(AbstractNetMessageIn *message);
+
+    //! Get the activity of the pool.
+    Stats getStats() const;
+
+private:
+
+    typedef std::vector<AbstractNetMessageIn*> FreeList;
+
+    UInt32 m_id;              //!< unique identifier, for the thread caches
+    UInt32 m_maxFree;
+
+    FastMutex m_mutex;
+    std::vector<FreeList> m_free;   //!< one per registered prototype
+
+    std::atomic<UInt64> m_numAcquires;
+    std::atomic<UInt64> m_numAllocations;
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETMESSAGEPOOL_H
@@ -0,0 +1,450 @@
+/**
+ * @file netmessageschema.h
+ * @brief Compile-time message schemas generating the read and write code.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETMESSAGESCHEMA_H
+#define _O3D_NETMESSAGESCHEMA_H
+
+#include "netmessageadapter.h"
+#include "netcodec.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Wire representation of a field type.
+ * @details Wire is the unsigned integer stored in the buffer byte order, and RAW
+ * is true when the in-memory value can be copied as is for the native byte order.
+ */
+template <class T>
+struct NetFieldTraits;
+
+#define O3D_NET_FIELD_TRAITS(TYPE, WIRE)                                        \
+template <>                                                                     \
+struct NetFieldTraits<TYPE>                                                     \
+{                                                                               \
+    typedef WIRE Wire;                                                          \
+    static const Bool RAW = True;                                               \
+    static inline Wire toWire(TYPE value) { return static_cast<Wire>(value); }  \
+    static inline TYPE fromWire(Wire value) { return static_cast<TYPE>(value); }\
+};
+
+O3D_NET_FIELD_TRAITS(Int8, UInt8)
+O3D_NET_FIELD_TRAITS(UInt8, UInt8)
+O3D_NET_FIELD_TRAITS(Int16, UInt16)
+O3D_NET_FIELD_TRAITS(UInt16, UInt16)
+O3D_NET_FIELD_TRAITS(Int32, UInt32)
+O3D_NET_FIELD_TRAITS(UInt32, UInt32)
+O3D_NET_FIELD_TRAITS(Int64, UInt64)
+O3D_NET_FIELD_TRAITS(UInt64, UInt64)
+
+#undef O3D_NET_FIELD_TRAITS
+
+template <>
+struct NetFieldTraits<Float>
+{
+    typedef UInt32 Wire;
+    static const Bool RAW = True;
+    static inline Wire toWire(Float value) { Wire wire; memcpy(&wire, &value, 4); return wire; }
+    static inline Float fromWire(Wire wire) { Float value; memcpy(&value, &wire, 4); return value; }
+};
+
+template <>
+struct NetFieldTraits<Double>
+{
+    typedef UInt64 Wire;
+    static const Bool RAW = True;
+    static inline Wire toWire(Double value) { Wire wire; memcpy(&wire, &value, 8); return wire; }
+    static inline Double fromWire(Wire wire) { Double value; memcpy(&value, &wire, 8); return value; }
+};
+
+//! A received byte is not always a valid bool, so it is never copied as is.
+template <>
+struct NetFieldTraits<Bool>
+{
+    typedef UInt8 Wire;
+    static const Bool RAW = False;
+    static inline Wire toWire(Bool value) { return value ? 1 : 0; }
+    static inline Bool fromWire(Wire wire) { return wire != 0; }
+};
+
+/**
+ * @brief A field of a schema, a member of the CLASS at the offset OFFSET.
+ * @note Use the O3D_NET_FIELD macro to declare it.
+ */
+template <class CLASS, class T, T CLASS::*MEMBER, size_t OFFSET>
+struct NetField
+{
+    typedef NetFieldTraits<T> Traits;
+    typedef typename Traits::Wire Wire;
+
+    static const UInt32 SIZE = sizeof(Wire);
+    static const size_t MEMBER_OFFSET = OFFSET;
+    static const Bool RAW = Traits::RAW && (sizeof(T) == sizeof(Wire));
+
+    template <System::ByteOrder ORDER>
+    static inline void store(UInt8 *data, const CLASS &object)
+    {
+        NetByteOrderCodec<ORDER>::template store<Wire>(data, Traits::toWire(object.*MEMBER));
+    }
+
+    template <System::ByteOrder ORDER>
+    static inline void load(const UInt8 *data, CLASS &object)
+    {
+        object.*MEMBER = Traits::fromWire(NetByteOrderCodec<ORDER>::template load<Wire>(data));
+    }
+
+    //! Compare the wire values, so a float is compared bitwise.
+    static inline Bool changed(const CLASS &a, const CLASS &b)
+    {
+        return Traits::toWire(a.*MEMBER) != Traits::toWire(b.*MEMBER);
+    }
+};
+
+//! Declare the field MEMBER of CLASS, for a NetSchema.
+#define O3D_NET_FIELD(CLASS, MEMBER) \
+    o3d::net::NetField<CLASS, decltype(CLASS::MEMBER), &CLASS::MEMBER, offsetof(CLASS, MEMBER)>
+
+//! Recursion over the fields of a schema.
+template <class CLASS, class... FIELDS>
+struct NetSchemaFields
+{
+    static const UInt32 SIZE = 0;
+    static const UInt32 COUNT = 0;
+
+    static constexpr Bool isRaw(size_t) { return True; }
+
+    template <System::ByteOrder ORDER>
+    static inline void store(UInt8 *, const CLASS &) {}
+
+    template <System::ByteOrder ORDER>
+    static inline void load(const UInt8 *, CLASS &) {}
+
+    static inline UInt32 diff(const CLASS &, const CLASS &, UInt32) { return 0; }
+    static inline UInt32 maskedSize(UInt32) { return 0; }
+
+    template <System::ByteOrder ORDER>
+    static inline UInt8* storeMasked(UInt8 *data, const CLASS &, UInt32) { return data; }
+
+    template <System::ByteOrder ORDER>
+    static inline const UInt8* loadMasked(const UInt8 *data, CLASS &, UInt32) { return data; }
+};
+
+template <class CLASS, class FIELD, class... FIELDS>
+struct NetSchemaFields<CLASS, FIELD, FIELDS...>
+{
+    typedef NetSchemaFields<CLASS, FIELDS...> Next;
+
+    static const UInt32 SIZE = FIELD::SIZE + Next::SIZE;
+    static const UInt32 COUNT = 1 + Next::COUNT;
+
+    //! True if the fields are laid out in memory exactly as on the wire.
+    static constexpr Bool isRaw(size_t offset)
+    {
+        return FIELD::RAW && (FIELD::MEMBER_OFFSET == offset) && Next::isRaw(offset + FIELD::SIZE);
+    }
+
+    template <System::ByteOrder ORDER>
+    static inline void store(UInt8 *data, const CLASS &object)
+    {
+        FIELD::template store<ORDER>(data, object);
+        Next::template store<ORDER>(data + FIELD::SIZE, object);
+    }
+
+    template <System::ByteOrder ORDER>
+    static inline void load(const UInt8 *data, CLASS &object)
+    {
+        FIELD::template load<ORDER>(data, object);
+        Next::template load<ORDER>(data + FIELD::SIZE, object);
+    }
+
+    //! Mask of the fields that differ, the first field being at the bit.
+    static inline UInt32 diff(const CLASS &a, const CLASS &b, UInt32 bit)
+    {
+        return (FIELD::changed(a, b) ? (1u << bit) : 0u) | Next::diff(a, b, bit + 1);
+    }
+
+    //! Size in bytes of the fields of the mask, the first field being at the bit 0.
+    static inline UInt32 maskedSize(UInt32 mask)
+    {
+        return ((mask & 1) ? FIELD::SIZE : 0) + Next::maskedSize(mask >> 1);
+    }
+
+    //! Store the fields of the mask only, packed, and return the end of the data.
+    template <System::ByteOrder ORDER>
+    static inline UInt8* storeMasked(UInt8 *data, const CLASS &object, UInt32 mask)
+    {
+        if (mask & 1)
+        {
+            FIELD::template store<ORDER>(data, object);
+            data += FIELD::SIZE;
+        }
+
+        return Next::template storeMasked<ORDER>(data, object, mask >> 1);
+    }
+
+    //! Load the fields of the mask only, the others are left untouched.
+    template <System::ByteOrder ORDER>
+    static inline const UInt8* loadMasked(const UInt8 *data, CLASS &object, UInt32 mask)
+    {
+        if (mask & 1)
+        {
+            FIELD::template load<ORDER>(data, object);
+            data += FIELD::SIZE;
+        }
+
+        return Next::template loadMasked<ORDER>(data, object, mask >> 1);
+    }
+};
+
+/**
+ * @brief Compile-time schema of a message, deriving its serialization.
+ * @details The fields of a plain structure are declared once, in their wire order:
+ * @code
+ * struct EntityState { UInt32 id; Float x, y, z; UInt16 flags; };
+ *
+ * typedef NetSchema<EntityState,
+ *         O3D_NET_FIELD(EntityState, id),
+ *         O3D_NET_FIELD(EntityState, x),
+ *         O3D_NET_FIELD(EntityState, y),
+ *         O3D_NET_FIELD(EntityState, z),
+ *         O3D_NET_FIELD(EntityState, flags)> EntityStateSchema;
+ * @endcode
+ * The whole message is encoded or decoded in place in the buffer span, with a
+ * single extend or skip, and no virtual call per field. When the structure has no
+ * padding and its members follow the wire order (RAW), a buffer in the native byte
+ * order gets a single memcpy.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+template <class CLASS, class... FIELDS>
+class NetSchema
+{
+public:
+
+    typedef CLASS Data;
+    typedef NetSchemaFields<CLASS, FIELDS...> Fields;
+
+    //! Size in bytes of the message on the wire.
+    static const UInt32 WIRE_SIZE = Fields::SIZE;
+
+    //! Number of fields.
+    static const UInt32 NUM_FIELDS = Fields::COUNT;
+
+    //! True if the structure can be copied as is for the native byte order.
+    static const Bool RAW = std::is_trivially_copyable<CLASS>::value &&
+                            (sizeof(CLASS) == WIRE_SIZE) &&
+                            Fields::isRaw(0);
+
+    static_assert(WIRE_SIZE <= 0x7fff, "Schema wire size must fit a default message");
+
+    //! Write the fields in the byte order of the buffer.
+    static void write(NetBuffer *buffer, const CLASS &object)
+    {
+        const System::ByteOrder order = buffer->getByteOrder();
+
+        if (RAW && (order == System::getNativeByteOrder()))
+        {
+            buffer->write(reinterpret_cast<const UInt8*>(&object), WIRE_SIZE);
+            return;
+        }
+
+        UInt32 size = 0;
+        UInt8 *data = buffer->getWritableSpan(size);
+
+        if (size >= WIRE_SIZE)
+        {
+            store(order, data, object);
+            buffer->extend(WIRE_SIZE);
+        }
+        else
+        {
+            UInt8 temp[WIRE_SIZE > 0 ? WIRE_SIZE : 1];
+            store(order, temp, object);
+
+            buffer->write(temp, WIRE_SIZE);
+        }
+    }
+
+    //! Read the fields in the byte order of the buffer.
+    //! @return False if less than WIRE_SIZE bytes are available, nothing is read then.
+    static Bool read(NetBuffer *buffer, CLASS &object)
+    {
+        if ((UInt32)buffer->getAvailable() < WIRE_SIZE)
+            return False;
+
+        const System::ByteOrder order = buffer->getByteOrder();
+
+        if (RAW && (order == System::getNativeByteOrder()))
+        {
+            buffer->read(reinterpret_cast<UInt8*>(&object), WIRE_SIZE);
+            return True;
+        }
+
+        UInt32 size = 0;
+        const UInt8 *data = buffer->getReadableSpan(size);
+
+        if (size >= WIRE_SIZE)
+        {
+            load(order, data, object);
+            buffer->skip(WIRE_SIZE);
+        }
+        else
+        {
+            UInt8 temp[WIRE_SIZE > 0 ? WIRE_SIZE : 1];
+            buffer->read(temp, WIRE_SIZE);
+
+            load(order, temp, object);
+        }
+
+        return True;
+    }
+
+    /**
+     * @brief changeMask Field-level change mask, for a delta encoding.
+     * @return A bit per field that differs between the object and the baseline, the
+     * first field being at the bit 0.
+     */
+    static inline UInt32 changeMask(const CLASS &object, const CLASS &baseline)
+    {
+        static_assert(NUM_FIELDS <= 32, "A delta encoded schema has at most 32 fields");
+        return Fields::diff(object, baseline, 0);
+    }
+
+    //! Write only the fields of the mask, packed in their order, without the mask.
+    static void writeMasked(NetBuffer *buffer, const CLASS &object, UInt32 mask)
+    {
+        UInt8 temp[WIRE_SIZE > 0 ? WIRE_SIZE : 1];
+        UInt8 *end;
+
+        if (buffer->getByteOrder() == System::ORDER_BIG_ENDIAN)
+            end = Fields::template storeMasked<System::ORDER_BIG_ENDIAN>(temp, object, mask);
+        else
+            end = Fields::template storeMasked<System::ORDER_LITTLE_ENDIAN>(temp, object, mask);
+
+        if (end > temp)
+            buffer->write(temp, static_cast<UInt32>(end - temp));
+    }
+
+    //! Read the fields of the mask written by writeMasked, the others are untouched.
+    //! @return False if the fields are not entirely available, nothing is read then.
+    static Bool readMasked(NetBuffer *buffer, CLASS &object, UInt32 mask)
+    {
+        const UInt32 n = Fields::maskedSize(mask);
+        if ((UInt32)buffer->getAvailable() < n)
+            return False;
+
+        if (n == 0)
+            return True;
+
+        UInt8 temp[WIRE_SIZE > 0 ? WIRE_SIZE : 1];
+        buffer->read(temp, static_cast<Int16>(n));
+
+        if (buffer->getByteOrder() == System::ORDER_BIG_ENDIAN)
+            Fields::template loadMasked<System::ORDER_BIG_ENDIAN>(temp, object, mask);
+        else
+            Fields::template loadMasked<System::ORDER_LITTLE_ENDIAN>(temp, object, mask);
+
+        return True;
+    }
+
+private:
+
+    static inline void store(System::ByteOrder order, UInt8 *data, const CLASS &object)
+    {
+        if (order == System::ORDER_BIG_ENDIAN)
+            Fields::template store<System::ORDER_BIG_ENDIAN>(data, object);
+        else
+            Fields::template store<System::ORDER_LITTLE_ENDIAN>(data, object);
+    }
+
+    static inline void load(System::ByteOrder order, const UInt8 *data, CLASS &object)
+    {
+        if (order == System::ORDER_BIG_ENDIAN)
+            Fields::template load<System::ORDER_BIG_ENDIAN>(data, object);
+        else
+            Fields::template load<System::ORDER_LITTLE_ENDIAN>(data, object);
+    }
+};
+
+/**
+ * @brief Incoming message helper whose content is read according to a schema.
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+template <class CLASS, UInt32 CODE, class SCHEMA>
+class O3D_NET_API_TEMPLATE NetSchemaMessageIn : public NetMessageInHelper<CLASS, CODE>
+{
+public:
+
+    typedef SCHEMA Schema;
+    typedef typename SCHEMA::Data Data;
+
+    virtual NetMessage* readFromBuffer(NetBuffer* buffer)
+    {
+        if (!SCHEMA::read(buffer, m_data))
+            O3D_ERROR(E_BufferOverflow("Read overflow"));
+
+        return nullptr;
+    }
+
+    inline const Data& getData() const { return m_data; }
+
+protected:
+
+    Data m_data;
+};
+
+/**
+ * @brief Outgoing message helper whose content is written according to a schema.
+ * @details The message size is known at compile time.
+ * @date 2026-10-16
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ */
+template <UInt32 CODE, class SCHEMA>
+class O3D_NET_API_TEMPLATE NetSchemaMessageOut : public NetMessageOutHelper<CODE>
+{
+public:
+
+    typedef SCHEMA Schema;
+    typedef typename SCHEMA::Data Data;
+
+    NetSchemaMessageOut()
+    {
+        this->m_messageDataSize = SCHEMA::WIRE_SIZE;
+    }
+
+    NetSchemaMessageOut(const Data &data) :
+        m_data(data)
+    {
+        this->m_messageDataSize = SCHEMA::WIRE_SIZE;
+    }
+
+    virtual NetMessage* writeToBuffer(NetBuffer* buffer)
+    {
+        SCHEMA::write(buffer, m_data);
+        return nullptr;
+    }
+
+    inline const Data& getData() const { return m_data; }
+    inline Data& getData() { return m_data; }
+
+    inline void setData(const Data &data) { m_data = data; }
+
+protected:
+
+    Data m_data;
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETMESSAGESCHEMA_H
@@ -29,6 +29,39 @@ public:
 
     virtual NetMessage* readFrom(NetBuffer* buffer, NetMessage* message) = 0;
     virtual NetMessage* writeTo(NetBuffer* buffer, NetMessage* message) = 0;
+
+    //! Called before the outgoing messages of a write pass are written. Default does nothing.
+    virtual void beginWrite(NetBuffer* buffer);
+
+    //! Called once the outgoing messages of a write pass are written. Default does nothing.
+    virtual void endWrite(NetBuffer* buffer);
+
+    /**
+     * @brief readHeader Called before each message code is read, to let the adapter
+     *        consume its own framing.
+     * @return False if more data are needed. Default returns true.
+     */
+    virtual Bool readHeader(NetBuffer* buffer);
+
+    /**
+     * @brief isShareable True if a single instance can be used by several connections
+     *        at once, meaning the adapter keeps no per connection state.
+     * @return Default returns true.
+     */
+    virtual Bool isShareable() const;
+};
+
+/**
+ * @brief Creates an adapter per connection, for the adapters which are not shareable.
+ */
+class O3D_NET_API NetReadWriteAdapterFactory
+{
+public:
+
+    virtual ~NetReadWriteAdapterFactory() = 0;
+
+    //! Create the adapter of a new connection, owned by the caller.
+    virtual NetReadWriteAdapter* createReadWriteAdapter() = 0;
 };
 
 } // namespace net
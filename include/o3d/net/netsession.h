@@ -13,6 +13,7 @@
 #include "socket.h"
 #include "netmessageadapter.h"
 #include "netreadwriteadapter.h"
+#include "netstringtable.h"
 
 #include <o3d/core/runnable.h>
 #include <o3d/core/mutex.h>
@@ -85,6 +86,31 @@ public:
     //! delete the read/write adapter.
     void deleteReadWriteAdapter();
 
+    /**
+     * @brief setBuffers Replace the default segmented read and write buffers.
+     * @param readBuffer A valid buffer, owned by the session.
+     * @param writeBuffer A valid buffer, owned by the session.
+     * @note Must be called before the session starts to exchange data.
+     */
+    void setBuffers(NetBuffer *readBuffer, NetBuffer *writeBuffer);
+
+    /**
+     * @brief enableStringInterning Attach a string table to the read and to the write
+     * buffers, used by the messages through NetBuffer::writeInternedUTF8 and
+     * NetBuffer::readInternedUTF8.
+     * @param capacity Number of strings of each table, must match the peer one.
+     * @param maxLength Maximal length in bytes of an interned string.
+     * @note Must be called before the session starts to exchange data, and the peer
+     * must enable it too.
+     */
+    void enableStringInterning(UInt32 capacity = 256, UInt32 maxLength = 256);
+
+    //! Get the string table of the received strings, or null.
+    inline NetStringTable* getReadStringTable() { return m_readStringTable; }
+
+    //! Get the string table of the sent strings, or null.
+    inline NetStringTable* getWriteStringTable() { return m_writeStringTable; }
+
 private:
 
     //! Simple One Producer and One Consumer Queue
@@ -140,14 +166,17 @@ private:
 
     ShutdownCause m_shutdownCause;
 
-    ArrayNetBuffer* m_readBuffer;
-    ArrayNetBuffer* m_writeBuffer;
+    NetBuffer* m_readBuffer;
+    NetBuffer* m_writeBuffer;
 
     NetMessageFactory* m_messageFactory;
 
     NetMessage* m_readPendingMessage;
     NetMessage* m_writePendingMessage;
 
+    NetStringTable* m_readStringTable;
+    NetStringTable* m_writeStringTable;
+
     PCQueue<NetMessage*>* m_outgoingList;
     PCQueue<NetMessage*>* m_incomingList;
 
@@ -0,0 +1,161 @@
+/**
+ * @file netstringtable.h
+ * @brief Per-connection bounded table of interned strings.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_NETSTRINGTABLE_H
+#define _O3D_NETSTRINGTABLE_H
+
+#include "net.h"
+
+#include <o3d/core/string.h>
+
+#include <vector>
+#include <string>
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Per-connection bounded table of interned strings, for a single direction.
+ * @details The writing side assigns a slot id to the first send of a string, and
+ * later sends transmit only the id. When the table is full the least recently used
+ * slot is reused. The reading side simply mirrors the slots defined by the peer, so
+ * both ends stay in sync without any extra message, as long as the stream is ordered
+ * and reliable.
+ * A connection uses one table for its write buffer and another one for its read
+ * buffer, both of the same capacity on the two peers (see NetBuffer::writeInternedUTF8).
+ * A slot is assigned while the message is serialized, before its frame is committed,
+ * so the adapters mark the table at the beginning of each frame, and roll it back with
+ * the frame if it is dropped. The slots defined since the mark are then forgotten,
+ * and their strings are defined again on their next send.
+ * Strings longer than the maximal length are never interned, and always sent as
+ * literals. A shared NetMessageFrame is encoded without a table, so it carries
+ * literals too, whereas a RawNetMessageIn forwarded as is by a proxy must not carry
+ * interned strings, because their ids only make sense on the incoming connection.
+ * @note Not thread safe, a table belongs to the single thread writing or reading the
+ * buffer.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetStringTable
+{
+public:
+
+    static const UInt32 MAX_CAPACITY = 65536;
+    static const UInt32 NO_SLOT = 0xffffffff;
+
+    struct Stats
+    {
+        UInt64 numHits;     //!< strings sent or received as an id
+        UInt64 numMisses;   //!< strings sent or received with a slot definition
+        UInt64 numLiterals; //!< strings sent or received not interned
+    };
+
+    /**
+     * @brief NetStringTable
+     * @param capacity Number of slots, in [1..MAX_CAPACITY], must match the peer one.
+     * @param maxLength Maximal length in bytes of an interned string.
+     */
+    NetStringTable(UInt32 capacity = 256, UInt32 maxLength = 256);
+
+    ~NetStringTable();
+
+    inline UInt32 getCapacity() const { return m_capacity; }
+    inline UInt32 getMaxLength() const { return m_maxLength; }
+
+    //! Forget every slot, must be done on both peers at the same time.
+    void clear();
+
+    //
+    // Writing side
+    //
+
+    /**
+     * @brief intern Find or assign the slot of an UTF-8 string.
+     * @param data UTF-8 data, not null terminated.
+     * @param length Length in bytes.
+     * @param defined Set to True if the slot has just been assigned, so the string
+     * must be sent with its id, or False if the peer already knows it.
+     * @return The slot id, or NO_SLOT if the string is too long to be interned.
+     */
+    UInt32 intern(const Char *data, UInt32 length, Bool &defined);
+
+    //! Begin a frame, the slots defined from now on can be rolled back.
+    void mark();
+
+    //! The frame is written, its slot definitions are kept.
+    void commit();
+
+    //! The frame is dropped, forget the slots defined since the mark.
+    void rollback();
+
+    //
+    // Reading side
+    //
+
+    /**
+     * @brief define Set the string of a slot, as defined by the peer.
+     * @exception E_InvalidParameter if the id is out of the capacity.
+     */
+    const String& define(UInt32 id, const Char *data, UInt32 length);
+
+    /**
+     * @brief lookup Get the string of a slot previously defined by the peer.
+     * @return The string, or null if the id is unknown.
+     */
+    const String* lookup(UInt32 id);
+
+    //! Count a literal string, for the statistics.
+    inline void countLiteral() { ++m_stats.numLiterals; }
+
+    inline const Stats& getStats() const { return m_stats; }
+
+private:
+
+    struct Entry
+    {
+        std::string data;   //!< UTF-8 bytes
+        Bool valid;         //!< in its bucket, else free for reuse
+        UInt32 hash;
+        UInt32 next;        //!< next slot of the same bucket
+        UInt32 prev;        //!< LRU toward the most recent
+        UInt32 older;       //!< LRU toward the least recent
+    };
+
+    UInt32 m_capacity;
+    UInt32 m_maxLength;
+
+    // writing side, created on the first intern
+    std::vector<Entry> m_entries;
+    std::vector<UInt32> m_buckets;
+    UInt32 m_bucketMask;
+    UInt32 m_numEntries;
+    UInt32 m_newest;
+    UInt32 m_oldest;
+
+    Bool m_marked;
+    std::vector<UInt32> m_pending;   //!< slots defined since the mark
+
+    // reading side, created on the first define
+    std::vector<String> m_strings;
+    std::vector<Bool> m_defined;
+
+    Stats m_stats;
+
+    static UInt32 hash(const Char *data, UInt32 length);
+
+    void unlink(UInt32 slot);
+    void pushNewest(UInt32 slot);
+    void pushOldest(UInt32 slot);
+    void removeFromBucket(UInt32 slot);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_NETSTRINGTABLE_H
@@ -11,6 +11,8 @@
 #define _O3D_NET_PROXY_MESSAGES_H
 
 #include "netmessageadapter.h"
+#include "rawnetmessagein.h"
+#include "proxyserver.h"
 #include <o3d/core/smartarray.h>
 #include <cstring>
 
@@ -113,6 +115,41 @@ private:
     o3d::SmartArrayUInt8 m_certificate;
 };
 
+/**
+ * @brief Raw message forwarded by the proxy server without being decoded (to set as
+ *        the passthrough prototype of the factory of the ProxyServer).
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class ProxyRawMessageIn : public RawNetMessageIn
+{
+public:
+
+    virtual AbstractNetMessageIn* makeInstance() const { return new ProxyRawMessageIn; }
+
+    virtual void run(void *context);
+};
+
+/**
+ * @brief Acknowledgement of a delta snapshot, advancing the baselines of the proxy
+ *        server session (with NetDeltaState::DELIVERY_ACKNOWLEDGED).
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+template <UInt32 CODE>
+class ProxyDeltaAckIn : public NetDeltaAckIn<ProxyDeltaAckIn<CODE>, CODE>
+{
+public:
+
+    virtual void run(void *context)
+    {
+        // run on proxy server side
+        ProxyServerSession *session = (ProxyServerSession*)context;
+        if (session->getDeltaState() != nullptr)
+            session->getDeltaState()->acknowledge(this->getSequence());
+    }
+};
+
 } // namespace net
 } // namespace o3d
 
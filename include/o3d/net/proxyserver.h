@@ -13,6 +13,7 @@
 
 #include "netserver.h"
 #include "netsession.h"
+#include "netdeltasnapshot.h"
 #include <o3d/core/scheduledthreadpool.h>
 #include <o3d/core/idmanager.h>
 #include <o3d/core/smartarray.h>
@@ -23,6 +24,30 @@ namespace o3d {
 namespace net {
 
 class ProxyServer;
+class RawNetMessageIn;
+
+/**
+ * @brief Routing of the raw messages forwarded by a proxy server.
+ * @details The decision only relies on the message code and size, the payload is
+ * never decoded.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API ProxyRouter
+{
+public:
+
+    virtual ~ProxyRouter() = 0;
+
+    /**
+     * @brief route Get the target of a raw message.
+     * @param sessionId Identifier of the source session.
+     * @param code Message code.
+     * @param size Payload size in bytes.
+     * @return Identifier of the target session, or -1 to drop the message.
+     */
+    virtual o3d::Int32 route(o3d::Int32 sessionId, o3d::UInt32 code, o3d::UInt32 size) = 0;
+};
 
 /**
  * @brief Proxy server net session instance.
@@ -98,12 +123,29 @@ public:
      */
     const ProxyServer* getProxyServer() const { return m_proxyServer; }
 
+    /**
+     * @brief forward Forward a raw message received by this session, according to
+     *        the router of the proxy server. Dropped if the session is not valid.
+     */
+    void forward(RawNetMessageIn *message);
+
+    /**
+     * @brief setDeltaState Define the delta encoding baselines of the session, owned.
+     * @param state A NetDeltaEncoder, or null to disable the delta snapshots.
+     * @note Must be set before the first ProxyServer::multicastDelta.
+     */
+    void setDeltaState(NetDeltaState *state);
+
+    //! Delta encoding baselines of the session, or null.
+    NetDeltaState* getDeltaState() const { return m_deltaState; }
+
 protected:
 
     ProxyServer *m_proxyServer;
 
     o3d::Int32 m_id;   //!< Unique session identifier per proxy server.
     NetSession *m_netSession;
+    NetDeltaState *m_deltaState;
 
     o3d::Bool m_cancel;
     o3d::Bool m_valid; //!< True means the session is valid and authentified
@@ -144,7 +186,9 @@ public:
     /**
      * @brief ProxyServer
      * @param factory A valid net message factory.
-     * @param adapter Net message adapter, if null use the default.
+     * @param adapter Net message adapter shared by the sessions, if null use the default.
+     * @exception E_InvalidParameter if the adapter is not shareable, an adapter factory
+     *            must be used instead (@see setReadWriteAdapterFactory).
      * @param port Server listen port number.
      * @param poolSize Number of execution threads.
      * @param delay Delay of execution of sessions.
@@ -181,11 +225,55 @@ public:
 
     /**
      * @brief multicast Send a message to any sessions.
-     * @param msg A valid message that can be consumed for any session (@see getNumSessions).
+     * @param msg A valid message, serialized once in a NetMessageFrame shared by
+     *        the sessions, then released. With an adapter factory only the payload is
+     *        serialized once, and each session frames it with its own adapter.
      * @note Multicast lock this mutex during this method.
      */
     void multicast(NetMessage *msg);
 
+    /**
+     * @brief multicastDelta Send a snapshot to every session having a delta state,
+     *        each session encoding only the changes against its own baselines.
+     * @param snapshot A valid snapshot, released once given to the sessions.
+     * @note The sessions whose delta state is not a NetDeltaEncoder<SCHEMA> are skipped.
+     *       Multicast lock this mutex during this method.
+     */
+    template <o3d::UInt32 CODE, class SCHEMA>
+    void multicastDelta(NetDeltaSnapshot<SCHEMA> *snapshot)
+    {
+        FastMutexLocker locker(m_mutex);
+
+        for (std::pair<const o3d::Int32, ProxyServerSession*> &entry : m_sessions)
+        {
+            NetDeltaEncoder<SCHEMA> *encoder = NetDeltaEncoder<SCHEMA>::cast(entry.second->getDeltaState());
+            if (encoder != nullptr)
+            {
+                entry.second->send(new NetDeltaSnapshotOut<CODE, SCHEMA>(snapshot, encoder));
+            }
+        }
+
+        snapshot->release();
+    }
+
+    /**
+     * @brief forward Send a raw message to the session given by the router.
+     * @param sessionId Identifier of the source session.
+     * @param msg Raw message, retained for the target session. Dropped if there is no
+     *        router or no such target.
+     */
+    void forward(o3d::Int32 sessionId, RawNetMessageIn *msg);
+
+    /**
+     * @brief setRouter Define the routing of the raw messages, not owned.
+     * @note The factory must be in passthrough mode with a ProxyRawMessageIn prototype
+     *       (@see DefaultNetMessageFactory::setPassthrough).
+     */
+    void setRouter(ProxyRouter *router) { m_router = router; }
+
+    //! Routing of the raw messages, or null.
+    ProxyRouter* getRouter() const { return m_router; }
+
     /**
      * @brief getNumSessions
      * @return Number of currents sessions.
@@ -212,6 +300,16 @@ public:
     NetMessageFactory* getNetMessageFactory() const { return m_netMessageFactory; }
     NetReadWriteAdapter* getReadWriteAdapter() const { return m_readWriteAdapter; }
 
+    /**
+     * @brief setReadWriteAdapterFactory Give each session its own adapter, for the
+     *        adapters having a per connection state, not owned.
+     * @note Takes precedence over the shared adapter. Must be set before start().
+     */
+    void setReadWriteAdapterFactory(NetReadWriteAdapterFactory *factory) { m_readWriteAdapterFactory = factory; }
+
+    //! Per session adapter factory, or null.
+    NetReadWriteAdapterFactory* getReadWriteAdapterFactory() const { return m_readWriteAdapterFactory; }
+
     /**
      * @brief setVersion Define the protocol version. The client must have the same.
      * @param version
@@ -264,6 +362,8 @@ protected:
 
     NetMessageFactory *m_netMessageFactory;
     NetReadWriteAdapter *m_readWriteAdapter;
+    NetReadWriteAdapterFactory *m_readWriteAdapterFactory;
+    ProxyRouter *m_router;
 
     NetServer *m_server;
     NetSessionAcceptor *m_acceptor;
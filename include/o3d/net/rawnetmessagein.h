@@ -0,0 +1,77 @@
+/**
+ * @file rawnetmessagein.h
+ * @brief Incoming message kept as its raw payload, for passthrough forwarding.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_RAWNETMESSAGEIN_H
+#define _O3D_RAWNETMESSAGEIN_H
+
+#include "netmessageadapter.h"
+
+#include <atomic>
+#include <vector>
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Incoming message whose payload is kept as is, without any decoding.
+ * @details Instancied by a DefaultNetMessageFactory in passthrough mode for the
+ * unregistered message codes. The payload is copied once out of the read buffer, and
+ * the message can be sent as is to another session, whose adapter writes back its code
+ * and its size header, so the relay cost does not depend on the message content.
+ * The message is reference counted, consume() is thread-safe, so it can be retained
+ * by the session that forwards it while the target session writes it.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API RawNetMessageIn : public AbstractNetMessageIn
+{
+public:
+
+    RawNetMessageIn();
+    virtual ~RawNetMessageIn();
+
+    virtual UInt32 getMessageCode() const;
+
+    //! Set by the factory, according to the received code.
+    inline void setMessageCode(UInt32 code) { m_code = code; }
+
+    virtual AbstractNetMessageIn* makeInstance() const;
+
+    virtual void setMessageSize(UInt32 dataSize);
+
+    //! Copy the payload, returns this until it is entirely received.
+    virtual NetMessage* readFromBuffer(NetBuffer* buffer);
+
+    //! Write the payload as is.
+    virtual NetMessage* writeToBuffer(NetBuffer* buffer);
+
+    //! Decrement the reference counter, true when it reaches zero.
+    virtual Bool consume();
+
+    virtual void recycle();
+
+    //! Add a reference, before the message is sent to another session.
+    inline void retain() { m_refs.fetch_add(1, std::memory_order_relaxed); }
+
+    //! Payload bytes.
+    inline const UInt8* getData() const { return m_data.data(); }
+
+protected:
+
+    UInt32 m_code;
+    UInt32 m_received;
+
+    std::vector<UInt8> m_data;   //!< keeps its capacity when recycled
+    std::atomic<UInt32> m_refs;
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_RAWNETMESSAGEIN_H
@@ -0,0 +1,149 @@
+/**
+ * @file ringnetbuffer.h
+ * @brief Circular buffer that never moves its data.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_RINGNETBUFFER_H
+#define _O3D_RINGNETBUFFER_H
+
+#include "netbuffer.h"
+
+namespace o3d {
+namespace net {
+
+/**
+ * @brief Circular buffer that never moves its data.
+ * @details Read and write positions are logical counters, the physical offset being
+ * the position modulo the capacity. compact() does not copy anything, it only
+ * rebases the counters.
+ * When mirrored, the same memory is mapped twice contiguously, so any readable or
+ * writable region is contiguous, even when it wraps around the end of the ring.
+ * Mirroring is only available on POSIX systems, and the buffer silently falls back
+ * to a single mapping otherwise (spans are then cut at the end of the ring).
+ * Default byte-order is system native.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API RingNetBuffer : public NetBuffer
+{
+public:
+
+    /**
+     * @brief RingNetBuffer
+     * @param size Capacity in bytes, rounded up to a power of two (and to the page
+     *        size when mirrored).
+     * @param mirror Try to double-map the ring.
+     */
+    RingNetBuffer(UInt32 size, Bool mirror = True);
+
+    virtual ~RingNetBuffer();
+
+    virtual void writeInt8(Int8 value);
+    virtual void writeUInt8(UInt8 value);
+
+    virtual void writeInt16(Int16 value);
+    virtual void writeUInt16(UInt16 value);
+
+    virtual void writeInt32(Int32 value);
+    virtual void writeUInt32(UInt32 value);
+
+    virtual void writeInt64(Int64 value);
+    virtual void writeUInt64(UInt64 value);
+
+    virtual void writeUTF8(const String &string);
+    virtual void writeUTF8(const Char* string);
+    virtual void writeBool(Bool value);
+
+    virtual void write(const UInt8* buffer, UInt32 size);
+
+    virtual Int8 readInt8();
+    virtual UInt8 readUInt8();
+
+    virtual Int16 readInt16();
+    virtual UInt16 readUInt16();
+
+    virtual Int32 readInt32();
+    virtual UInt32 readUInt32();
+
+    virtual Int64 readInt64();
+    virtual UInt64 readUInt64();
+
+    virtual Bool readUTF8(Char* string, Int16 size);
+    virtual Bool readUTF8(String& string);
+    virtual Bool readBool();
+
+    virtual Bool read(UInt8* buffer, Int16 size);
+
+    virtual Int32 getAvailable() const;
+    virtual Int32 getFree() const;
+
+    virtual UInt32 getLimit() const;
+    virtual void setLimit(UInt32 limit);
+
+    virtual UInt32 getPosition() const;
+    virtual void setPosition(UInt32 position);
+
+    //! Address of the write position.
+    virtual UInt8* getWriteBuffer();
+    //! Address of the read position, a ring has no fixed origin.
+    virtual UInt8* getBuffer();
+
+    virtual UInt8* getReadableSpan(UInt32 &size);
+    virtual UInt8* getWritableSpan(UInt32 &size);
+
+    virtual UInt32 getReadableSegments(NetBufferSegment *segments, UInt32 max);
+    virtual UInt32 getWritableSegments(NetBufferSegment *segments, UInt32 max);
+
+    virtual void skip(UInt32 size);
+    virtual void extend(UInt32 size);
+
+    virtual void patch(UInt32 handle, const UInt8 *data, UInt32 size);
+
+    //! Rebase the positions, the data are never moved.
+    virtual void compact();
+
+    virtual void flip();
+
+    //! Set the byte order (little or big).
+    virtual void setByteOrder(System::ByteOrder order);
+
+    //! Get the byte order.
+    virtual System::ByteOrder getByteOrder() const;
+
+    //! Capacity in bytes.
+    inline UInt32 getSize() const { return m_size; }
+
+    //! True if the ring is double-mapped.
+    inline Bool isMirrored() const { return m_mirrored; }
+
+private:
+
+    System::ByteOrder m_byteOrder; //!< buffer byte order for read and write
+    Bool m_swap;                   //!< true mean swap byte order
+
+    Bool m_mirrored;               //!< double-mapped memory
+    UInt32 m_size;                 //!< capacity (power of two)
+    UInt8* m_array;                //!< ring memory
+    UInt32 m_readPosition;         //!< logical read position
+    UInt32 m_writePosition;        //!< logical write position
+
+    inline UInt8* at(UInt32 position) { return m_array + (position & (m_size - 1)); }
+
+    Bool mapMirror();
+    void unmapMirror();
+
+    void writeBytes(const UInt8 *data, UInt32 size);
+    void readBytes(UInt8 *data, UInt32 size);
+
+    void writeSwapped(const UInt8 *value, UInt32 size);
+    void readSwapped(UInt8 *value, UInt32 size);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_RINGNETBUFFER_H
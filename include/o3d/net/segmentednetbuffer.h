@@ -0,0 +1,243 @@
+/**
+ * @file segmentednetbuffer.h
+ * @brief Growable buffer made of a chain of pooled fixed-size segments.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_SEGMENTEDNETBUFFER_H
+#define _O3D_SEGMENTEDNETBUFFER_H
+
+#include "netbuffer.h"
+
+#include <o3d/core/mutex.h>
+
+#include <atomic>
+#include <vector>
+
+namespace o3d {
+namespace net {
+
+class NetBufferArena;
+
+/**
+ * @brief Pool of fixed-size memory segments shared by segmented buffers.
+ * @details Released segments are kept in a free list, up to maxFree, and given back
+ * by the next acquire. The pool is thread-safe, so buffers of sessions running
+ * on different threads can share it.
+ * In front of the shared free list, each thread keeps a small lock-free cache of
+ * segments of one pool, so a session thread that drains and refills its buffers
+ * mostly reuses its own segments. Cached segments are freed at the thread exit.
+ * Since a segmented buffer gives back its segments once drained, an idle session
+ * holds no segment at all.
+ * Segments are allocated on the heap, or drawn from a NetBufferArena to pack them
+ * into huge pages.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API NetBufferSegmentPool
+{
+public:
+
+    //! Occupancy of the pool.
+    struct Stats
+    {
+        UInt32 numInUse;        //!< segments currently held by buffers
+        UInt32 peakInUse;       //!< maximum of numInUse
+        UInt32 numFree;         //!< segments in the shared free list
+        UInt64 numAcquires;     //!< total number of acquire
+        UInt64 numAllocations;  //!< acquires that allocated a new segment
+    };
+
+    //! Maximum number of segments cached per thread.
+    static const UInt32 THREAD_CACHE_SIZE = 16;
+
+    /**
+     * @brief NetBufferSegmentPool
+     * @param segmentSize Size in bytes of each segment, must be a power of two.
+     * @param maxFree Maximum number of free segments kept by the pool.
+     * @param arena Optional arena to draw the segments from, its block size must be
+     * the segment size, and it must outlive the pool and the threads using the pool.
+     */
+    NetBufferSegmentPool(
+            UInt32 segmentSize = 4096,
+            UInt32 maxFree = 1024,
+            NetBufferArena *arena = nullptr);
+
+    virtual ~NetBufferSegmentPool();
+
+    //! Get a segment from the free list or allocate a new one.
+    UInt8* acquire();
+
+    //! Give back a segment previously acquired from this pool.
+    void release(UInt8 *segment);
+
+    //! Size in bytes of each segment.
+    inline UInt32 getSegmentSize() const { return m_segmentSize; }
+
+    //! Number of segments currently kept in the free list.
+    UInt32 getNumFree() const;
+
+    //! Get the occupancy of the pool.
+    Stats getStats() const;
+
+    //! Arena the segments are drawn from, or null.
+    inline NetBufferArena* getArena() const { return m_arena; }
+
+    //! Default shared pool of 4096 bytes segments, or the one defined by setDefault().
+    static NetBufferSegmentPool* getDefault();
+
+    //! Replace the default pool, for example by one drawing from an arena.
+    //! Must be called before any buffer uses the default pool, null restores it.
+    static void setDefault(NetBufferSegmentPool *pool);
+
+private:
+
+    UInt32 m_id;              //!< unique identifier, for the thread caches
+    UInt32 m_segmentSize;
+    UInt32 m_maxFree;
+
+    NetBufferArena *m_arena;
+
+    FastMutex m_mutex;
+    std::vector<UInt8*> m_free;
+
+    std::atomic<UInt32> m_numInUse;
+    std::atomic<UInt32> m_peakInUse;
+    std::atomic<UInt64> m_numAcquires;
+    std::atomic<UInt64> m_numAllocations;
+
+    void acquired();
+
+    UInt8* allocate();
+    void deallocate(UInt8 *segment);
+};
+
+/**
+ * @brief Growable buffer made of a chain of pooled fixed-size segments.
+ * @details Segments are acquired from the pool on demand while writing, and given
+ * back once drained during compact(). Positions and limit are logical offsets from
+ * the beginning of the first segment. The capacity is only bounded by maxSize.
+ * getBuffer() and getWriteBuffer() only give access to the current segment, so bulk
+ * accesses must use getReadableSpan() and getWritableSpan().
+ * Default byte-order is system native.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ */
+class O3D_NET_API SegmentedNetBuffer : public NetBuffer
+{
+public:
+
+    /**
+     * @brief SegmentedNetBuffer
+     * @param pool Segment pool, or null to use the default shared pool.
+     * @param maxSize Maximal number of pending bytes the buffer can hold.
+     */
+    SegmentedNetBuffer(NetBufferSegmentPool *pool = nullptr, UInt32 maxSize = 16*1024*1024);
+
+    virtual ~SegmentedNetBuffer();
+
+    virtual void writeInt8(Int8 value);
+    virtual void writeUInt8(UInt8 value);
+
+    virtual void writeInt16(Int16 value);
+    virtual void writeUInt16(UInt16 value);
+
+    virtual void writeInt32(Int32 value);
+    virtual void writeUInt32(UInt32 value);
+
+    virtual void writeInt64(Int64 value);
+    virtual void writeUInt64(UInt64 value);
+
+    virtual void writeUTF8(const String &string);
+    virtual void writeUTF8(const Char* string);
+    virtual void writeBool(Bool value);
+
+    virtual void write(const UInt8* buffer, UInt32 size);
+
+    virtual Int8 readInt8();
+    virtual UInt8 readUInt8();
+
+    virtual Int16 readInt16();
+    virtual UInt16 readUInt16();
+
+    virtual Int32 readInt32();
+    virtual UInt32 readUInt32();
+
+    virtual Int64 readInt64();
+    virtual UInt64 readUInt64();
+
+    virtual Bool readUTF8(Char* string, Int16 size);
+    virtual Bool readUTF8(String& string);
+    virtual Bool readBool();
+
+    virtual Bool read(UInt8* buffer, Int16 size);
+
+    virtual Int32 getAvailable() const;
+    virtual Int32 getFree() const;
+
+    virtual UInt32 getLimit() const;
+    virtual void setLimit(UInt32 limit);
+
+    virtual UInt32 getPosition() const;
+    virtual void setPosition(UInt32 position);
+
+    virtual UInt8* getWriteBuffer();
+    virtual UInt8* getBuffer();
+
+    virtual UInt8* getReadableSpan(UInt32 &size);
+    virtual UInt8* getWritableSpan(UInt32 &size);
+
+    virtual UInt32 getReadableSegments(NetBufferSegment *segments, UInt32 max);
+    virtual UInt32 getWritableSegments(NetBufferSegment *segments, UInt32 max);
+
+    virtual void skip(UInt32 size);
+    virtual void extend(UInt32 size);
+
+    virtual void patch(UInt32 handle, const UInt8 *data, UInt32 size);
+
+    //! Give back the drained segments to the pool.
+    virtual void compact();
+
+    virtual void flip();
+
+    //! Set the byte order (little or big).
+    virtual void setByteOrder(System::ByteOrder order);
+
+    //! Get the byte order.
+    virtual System::ByteOrder getByteOrder() const;
+
+    //! Number of segments currently held by the buffer.
+    inline UInt32 getNumSegments() const { return (UInt32)m_segments.size(); }
+
+private:
+
+    NetBufferSegmentPool *m_pool;
+
+    System::ByteOrder m_byteOrder; //!< buffer byte order for read and write
+    Bool m_swap;                   //!< true mean swap byte order
+
+    UInt32 m_segmentSize;          //!< size of a segment (power of two)
+    UInt32 m_segmentShift;         //!< log2 of the segment size
+    UInt32 m_maxSize;              //!< maximal pending bytes
+
+    std::vector<UInt8*> m_segments; //!< chain of segments
+    UInt32 m_readPosition;          //!< current logical read position
+    UInt32 m_writePosition;         //!< current logical write position
+
+    //! Acquire segments until size bytes can be written.
+    void grow(UInt32 size);
+
+    void writeBytes(const UInt8 *data, UInt32 size);
+    void readBytes(UInt8 *data, UInt32 size);
+
+    void writeSwapped(const UInt8 *value, UInt32 size);
+    void readSwapped(UInt8 *value, UInt32 size);
+};
+
+} // namespace net
+} // namespace o3d
+
+#endif // _O3D_SEGMENTEDNETBUFFER_H
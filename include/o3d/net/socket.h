@@ -51,6 +51,7 @@ namespace o3d {
 namespace net {
 
 class NetBuffer;
+struct NetBufferSegment;
 
 //---------------------------------------------------------------------------------------
 //! @class Socket
@@ -101,13 +102,19 @@ public:
 	//! Send a packet
 	Int32 send(const UInt8* pData,Int32 len,Int32 option = 0);
 
-	//! Send data from buffer
+	//! Send several regions at once (gather), with a single system call
+	Int32 send(const NetBufferSegment *segments, UInt32 count, Int32 option = 0);
+
+	//! Send data from buffer, every readable segment with a single system call
 	Int32 sendFromBuffer(NetBuffer* buffer, Int32 option = 0);
 
 	//! Receive a packet
 	Int32 receive(UInt8* pData,Int32 len,Int32 option = 0);
 
-	//! Receive data into O3DBuffer
+	//! Receive into several regions at once (scatter), with a single system call
+	Int32 receive(const NetBufferSegment *segments, UInt32 count, Int32 option = 0);
+
+	//! Receive data into O3DBuffer, filling every writable segment with a single system call
 	Int32 receiveIntoBuffer(NetBuffer* buffer, Int32 option = 0);
 
 	//! Send a packet to a specific address
@@ -0,0 +1,254 @@
+/**
+ * @file batchnetmessageadapter.cpp
+ * @brief Read/write adapter coalescing the messages of a write pass in a batch frame.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+#include <o3d/core/architecture.h>
+
+#include "o3d/net/batchnetmessageadapter.h"
+#include "o3d/net/netbuffer.h"
+#include "o3d/net/netcodec.h"
+#include <o3d/core/debug.h>
+
+using namespace o3d;
+using namespace o3d::net;
+
+BatchNetMessageAdapter::BatchNetMessageAdapter() :
+    m_writing(False),
+    m_batchOpen(False),
+    m_batchSlot(0),
+    m_batchStart(0),
+    m_batchRest(0),
+    m_batchMark(0),
+    m_numBatches(0),
+    m_numMessages(0)
+{
+}
+
+BatchNetMessageAdapter::~BatchNetMessageAdapter()
+{
+}
+
+Bool BatchNetMessageAdapter::readHeader(NetBuffer *buffer)
+{
+    if (m_batchRest > 0)
+    {
+        // next message of the batch, its consumed bytes are counted from there
+        m_batchMark = buffer->getAvailable();
+        return True;
+    }
+
+    // a message outside of a batch
+    buffer->mark();
+
+    if (buffer->readUInt8() != BATCH_LEAD)
+    {
+        buffer->rollback();
+        return True;
+    }
+
+    UInt32 size = 0;
+    if (!buffer->tryReadVarUInt32(size))
+    {
+        buffer->rollback();
+        return False;
+    }
+
+    // a batch is closed past MAX_BATCH_SIZE, so its last message can exceed it
+    if (size == 0 || size > 2*MAX_BATCH_SIZE + 8)
+        O3D_ERROR(E_BufferException("Invalid batch size"));
+
+    // the whole batch must be available
+    if (!buffer->ensureReadable(size))
+    {
+        buffer->rollback();
+        return False;
+    }
+
+    buffer->commit();
+
+    m_batchRest = size;
+    m_batchMark = buffer->getAvailable();
+
+    return True;
+}
+
+NetMessage* BatchNetMessageAdapter::readFrom(NetBuffer* buffer, NetMessage* message)
+{
+    AbstractNetMessage* m = reinterpret_cast<AbstractNetMessage*>(message);
+    UInt32 size = 0;
+
+    if (m_batchRest > 0)
+    {
+        // the batch is entirely available
+        size = buffer->readVarUInt32();
+
+        m->setMessageSize(size);
+        message->readFromBuffer(buffer);
+
+        const UInt32 consumed = m_batchMark - buffer->getAvailable();
+        if (consumed > m_batchRest)
+            O3D_ERROR(E_BufferException("Invalid message size"));
+
+        m_batchRest -= consumed;
+        return nullptr;
+    }
+
+    buffer->mark();
+
+    if (!buffer->tryReadVarUInt32(size))
+        return message;
+
+    if (size > 0xffff)
+        O3D_ERROR(E_BufferException("Invalid message size"));
+
+    if (!buffer->ensureReadable(size))
+    {
+        buffer->rollback();
+        return message;
+    }
+
+    buffer->commit();
+
+    m->setMessageSize(size);
+    message->readFromBuffer(buffer);
+
+    return nullptr;
+}
+
+Bool BatchNetMessageAdapter::isShareable() const
+{
+    return False;
+}
+
+void BatchNetMessageAdapter::beginWrite(NetBuffer *buffer)
+{
+    m_writing = True;
+    m_batchOpen = False;
+}
+
+void BatchNetMessageAdapter::endWrite(NetBuffer *buffer)
+{
+    if (m_batchOpen)
+        closeBatch(buffer);
+
+    m_writing = False;
+}
+
+void BatchNetMessageAdapter::closeBatch(NetBuffer *buffer)
+{
+    const UInt32 batchSize = buffer->getLimit() - m_batchStart;
+
+    UInt8 data[3];
+    NetVarInt::encodePadded(data, batchSize, 3);
+
+    buffer->patch(m_batchSlot, data, 3);
+    m_batchOpen = False;
+
+    ++m_numBatches;
+}
+
+void BatchNetMessageAdapter::dropFrame(NetBuffer *buffer, UInt32 frameStart, Bool openBatch)
+{
+    buffer->setLimit(frameStart);
+    buffer->rollbackFrame();
+
+    // the exception leaves the write pass, so the batch is closed with the
+    // previous messages, or dropped if it was opened for this one
+    if (openBatch)
+        m_batchOpen = False;
+    else if (m_batchOpen)
+        closeBatch(buffer);
+}
+
+NetMessage* BatchNetMessageAdapter::writeTo(NetBuffer* buffer, NetMessage* message)
+{
+    AbstractNetMessage* m = reinterpret_cast<AbstractNetMessage*>(message);
+    UInt32 size = m->getMessageSize();
+
+    if (size > 0xffff)
+        O3D_ERROR(E_BufferOverflow("Message size overflow"));
+
+    // we need at least size + 3 bytes of message size + [1..4] bytes of message code,
+    // and 4 bytes if a batch is opened
+    if ((UInt32)buffer->getFree() < size + 11)
+    {
+        return message;
+    }
+
+    // keep the batch size lesser than its 3 bytes varint limit
+    if (m_writing && m_batchOpen && (buffer->getLimit() - m_batchStart >= MAX_BATCH_SIZE))
+        closeBatch(buffer);
+
+    const UInt32 frameStart = buffer->getLimit();
+    const Bool openBatch = m_writing && !m_batchOpen;
+
+    buffer->beginFrame();
+
+    if (openBatch)
+    {
+        buffer->writeUInt8(BATCH_LEAD);
+        m_batchSlot = buffer->reserve(3);
+        m_batchStart = buffer->getLimit();
+        m_batchOpen = True;
+    }
+
+    DefaultNetMessageAdapter::writeMessageCode(buffer, m->getMessageCode());
+
+    // a declared size is written as a minimal varint, else the slot is reserved
+    // and patched once the message is serialized
+    const Bool patchSize = size == 0;
+    UInt32 sizeSlot = 0;
+
+    if (patchSize)
+        sizeSlot = buffer->reserve(3);
+    else
+        buffer->writeVarUInt32(size);
+
+    UInt32 start = buffer->getLimit();
+
+    // a partial frame must never be sent
+    try
+    {
+        message->writeToBuffer(buffer);
+    }
+    catch (...)
+    {
+        dropFrame(buffer, frameStart, openBatch);
+        throw;
+    }
+
+    UInt32 stop = buffer->getLimit();
+
+    if (patchSize)
+    {
+        const UInt32 dataSize = stop - start;
+
+        // same limit as the declared size, drop the partial frame before throwing
+        if (dataSize > 0xffff)
+        {
+            dropFrame(buffer, frameStart, openBatch);
+            O3D_ERROR(E_BufferOverflow("Message size overflow"));
+        }
+
+        UInt8 data[3];
+        NetVarInt::encodePadded(data, dataSize, 3);
+
+        buffer->patch(sizeSlot, data, 3);
+    }
+    else if ((stop - start) != size)
+    {
+        O3D_WARNING(String("Invalid Message Size detected ") << m->getDump() << " " << (stop - start) << " " << size);
+    }
+
+    buffer->commitFrame();
+
+    ++m_numMessages;
+
+    return nullptr;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file bitnetbuffer.cpp
+ * @brief Bit-level packing cursors over a NetBuffer.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/bitnetbuffer.h"
+#include "o3d/net/netcodec.h"
+#include <o3d/core/debug.h>
+
+#include <cmath>
+
+using namespace o3d;
+using namespace o3d::net;
+
+BitNetWriter::BitNetWriter(NetBuffer *buffer) :
+    m_buffer(buffer),
+    m_scratch(0),
+    m_scratchBits(0),
+    m_bitCount(0)
+{
+    O3D_CHECKPTR(buffer);
+}
+
+void BitNetWriter::writeRangedInt(Int32 value, Int32 min, Int32 max)
+{
+    if (value < min)
+        value = min;
+    else if (value > max)
+        value = max;
+
+    const UInt32 range = static_cast<UInt32>(static_cast<Int64>(max) - min);
+    writeBits(static_cast<UInt32>(static_cast<Int64>(value) - min), bitsRequired(range));
+}
+
+void BitNetWriter::writeFixedFloat(Float value, Float min, Float max, Float precision)
+{
+    if (value < min)
+        value = min;
+    else if (value > max)
+        value = max;
+
+    const UInt32 steps = static_cast<UInt32>(std::ceil((max - min) / precision));
+
+    UInt32 q = static_cast<UInt32>(std::floor((value - min) / precision + 0.5f));
+    if (q > steps)
+        q = steps;
+
+    writeBits(q, bitsRequired(steps));
+}
+
+void BitNetWriter::flush()
+{
+    if (m_scratchBits == 0)
+        return;
+
+    UInt8 data[4];
+    const UInt32 bytes = (m_scratchBits + 7) >> 3;
+
+    for (UInt32 i = 0; i < bytes; ++i)
+    {
+        data[i] = static_cast<UInt8>(m_scratch >> (i << 3));
+    }
+
+    m_buffer->write(data, bytes);
+
+    m_scratch = 0;
+    m_scratchBits = 0;
+}
+
+UInt32 BitNetWriter::bitsRequired(UInt32 range)
+{
+    UInt32 bits = 0;
+    while (range != 0)
+    {
+        ++bits;
+        range >>= 1;
+    }
+
+    return bits;
+}
+
+void BitNetWriter::flushWord()
+{
+    UInt8 data[4];
+    LittleEndianCodec::store<UInt32>(data, static_cast<UInt32>(m_scratch));
+
+    m_buffer->write(data, 4);
+
+    m_scratch >>= 32;
+    m_scratchBits -= 32;
+}
+
+BitNetReader::BitNetReader(NetBuffer *buffer) :
+    m_buffer(buffer),
+    m_scratch(0),
+    m_scratchBits(0),
+    m_bitCount(0)
+{
+    O3D_CHECKPTR(buffer);
+}
+
+Int32 BitNetReader::readRangedInt(Int32 min, Int32 max)
+{
+    const UInt32 range = static_cast<UInt32>(static_cast<Int64>(max) - min);
+    return static_cast<Int32>(min + static_cast<Int64>(readBits(BitNetWriter::bitsRequired(range))));
+}
+
+Float BitNetReader::readFixedFloat(Float min, Float max, Float precision)
+{
+    const UInt32 steps = static_cast<UInt32>(std::ceil((max - min) / precision));
+    const Float value = min + readBits(BitNetWriter::bitsRequired(steps)) * precision;
+
+    return value > max ? max : value;
+}
+
+void BitNetReader::align()
+{
+    const UInt32 padding = m_scratchBits & 7;
+
+    m_scratch >>= padding;
+    m_scratchBits -= padding;
+}
+
+void BitNetReader::fill(UInt32 bits)
+{
+    // only the missing bytes, to never read past the writer flush
+    UInt8 data[4];
+    const UInt32 bytes = (bits - m_scratchBits + 7) >> 3;
+
+    if (!m_buffer->read(data, static_cast<Int16>(bytes)))
+    {
+        O3D_ERROR(E_BufferOverflow("Read overflow"));
+    }
+
+    for (UInt32 i = 0; i < bytes; ++i)
+    {
+        m_scratch |= static_cast<UInt64>(data[i]) << m_scratchBits;
+        m_scratchBits += 8;
+    }
+}
@@ -14,17 +14,86 @@
 #include <o3d/core/debug.h>
 #include "o3d/net/netbuffer.h"
 #include "o3d/net/genericmessagein.h"
+#include "o3d/net/rawnetmessagein.h"
+#include "o3d/net/netmessagepool.h"
 
 using namespace o3d;
 using namespace o3d::net;
 
+namespace {
+
+//! Length and bits mask of a message code, given by its lead byte.
+struct MessageCodeLead
+{
+    UInt8 length;   //!< 0 for an invalid lead byte
+    UInt8 mask;
+};
+
+struct MessageCodeLeads
+{
+    MessageCodeLead leads[256];
+
+    MessageCodeLeads()
+    {
+        for (UInt32 c = 0; c < 256; ++c)
+        {
+            MessageCodeLead &lead = leads[c];
+
+            if (c < 0x80)
+            {
+                // 0xxxxxxx
+                lead.length = 1;
+                lead.mask = 0x7F;
+            }
+            else if (c < 0xC0)
+            {
+                // 10xxxxxx is a continuation byte
+                lead.length = 0;
+                lead.mask = 0;
+            }
+            else if (c < 0xE0)
+            {
+                // 110xxxxx
+                lead.length = 2;
+                lead.mask = 0x1F;
+            }
+            else if (c < 0xF0)
+            {
+                // 1110xxxx
+                lead.length = 3;
+                lead.mask = 0x0F;
+            }
+            else if (c < 0xF8)
+            {
+                // 11110xxx
+                lead.length = 4;
+                lead.mask = 0x07;
+            }
+            else
+            {
+                lead.length = 0;
+                lead.mask = 0;
+            }
+        }
+    }
+};
+
+const MessageCodeLeads ms_messageCodeLeads;
+
+} // anonymous namespace
+
 NetMessageFactory::~NetMessageFactory()
 {
 
 }
 
-DefaultNetMessageFactory::DefaultNetMessageFactory()
+DefaultNetMessageFactory::DefaultNetMessageFactory(Bool pooling) :
+    m_pool(nullptr),
+    m_passthrough(nullptr)
 {
+    if (pooling)
+        m_pool = new NetMessagePool();
+
     registerMsg(new GenericMessageIn);
 }
 
@@ -32,13 +101,29 @@ void DefaultNetMessageFactory::registerMsg(AbstractNetMessageIn *msg)
 {
     UInt32 type = msg->getMessageCode();
 
+    if (type > DefaultNetMessageAdapter::MAX_MESSAGE_CODE)
+        O3D_ERROR(E_FactoryError(String("Net message code overflow [") << type << "]"));
+
+    // dense table, indexed by message code
     if (type >= m_msg.size())
         m_msg.resize(type+1, nullptr);
 
     if (m_msg[type] != nullptr)
-        throw new std::exception();
+        O3D_ERROR(E_FactoryError(String("Net message code already registered [") << type << "]"));
 
     m_msg[type] = msg;
+
+    if (m_pool)
+        m_pool->registerPrototype(msg);
+}
+
+void DefaultNetMessageFactory::setPassthrough(RawNetMessageIn *prototype)
+{
+    deletePtr(m_passthrough);
+    m_passthrough = prototype;
+
+    if (m_pool && m_passthrough)
+        m_pool->registerPrototype(m_passthrough);
 }
 
 DefaultNetMessageFactory::~DefaultNetMessageFactory()
@@ -47,72 +132,70 @@ DefaultNetMessageFactory::~DefaultNetMessageFactory()
     {
         deletePtr(msg);
     }
+
+    deletePtr(m_passthrough);
+
+    deletePtr(m_pool);
 }
 
 NetMessage* DefaultNetMessageFactory::buildFromBuffer(NetBuffer* buffer)
 {
     // multi-bytes message code (like UTF8)
+    UInt32 spanSize = 0;
+    const UInt8 *span = buffer->getReadableSpan(spanSize);
 
-    // first byte message byte
-    Int8 c0 = buffer->readInt8();
-    UInt32 code = 0;
+    if (spanSize == 0)
+        return nullptr;
 
-    // F0      80       80       80
-    //11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-    if ((c0 & 0xFE) == 0xFE)
-    {
-        Int8 c1 = buffer->readInt8();
-        Int8 c2 = buffer->readInt8();
-        Int8 c3 = buffer->readInt8();
-
-        code = (static_cast<UInt32>(
-                    ((c0 & 7) << 18) |
-                    ((c1 & 0x3F) << 12) |
-                    ((c2 & 0x3F) << 6) |
-                    (c3 & 0x3F)));
-    }
-    // E0       80       80
-    // 1110xxxx 10xxxxxx 10xxxxxx
-    else if ((c0 & 0xE0) == 0xE0)
-    {
-        Int8 c1 = buffer->readInt8();
-        Int8 c2 = buffer->readInt8();
+    // the lead byte gives the length of the code and the mask of its bits
+    const MessageCodeLead lead = ms_messageCodeLeads.leads[span[0]];
+    if (lead.length == 0)
+        O3D_ERROR(E_FactoryError(String("Invalid net message code lead byte [") << (UInt32)span[0] << "]"));
 
-        code = (static_cast<UInt32>(
-                    ((c0 & 0x0F) << 12) |
-                    ((c1 & 0x3F) << 6) |
-                    (c2 & 0x3F)));
-    }
-    // C0       80
-    // 110xxxxx 10xxxxxx
-    else if ((c0 & 0xC0) == 0xC0)
+    UInt8 bytes[4];
+    const UInt8 *data = span;
+
+    if (spanSize < lead.length)
     {
-        Int8 c1 = buffer->readInt8();
+        // split across two spans, or incomplete
+        if (!buffer->ensureReadable(lead.length))
+            return nullptr;
 
-        code = (static_cast<UInt32>(
-                    ((c0 & 0x1F) << 6) |
-                    (c1 & 0x3F)));
+        buffer->read(bytes, lead.length);
+        data = bytes;
     }
-    // 0xxxxxxx
-    else// if (c0 < 0x80)
+    else
     {
-        code = (static_cast<UInt32>(c0));
+        buffer->skip(lead.length);
     }
 
-    if (code >= m_msg.size())
+    UInt32 code = data[0] & lead.mask;
+
+    for (UInt32 i = 1; i < lead.length; ++i)
     {
-        O3D_WARNING(String("Undefined net message type [") << code << "]");
-        return new GenericMessageIn();
+        // 10xxxxxx
+        if ((data[i] & 0xC0) != 0x80)
+            O3D_ERROR(E_FactoryError("Invalid net message code"));
+
+        code = (code << 6) | (data[i] & 0x3F);
     }
 
-    AbstractNetMessageIn *msg = m_msg[code];
+    AbstractNetMessageIn *msg = code < m_msg.size() ? m_msg[code] : nullptr;
 
     if (msg != nullptr)
-        return msg->makeInstance();
+        return m_pool ? m_pool->acquire(msg) : msg->makeInstance();
+    else if (m_passthrough != nullptr)
+    {
+        // kept raw, to be forwarded
+        RawNetMessageIn *raw = static_cast<RawNetMessageIn*>(
+                    m_pool ? m_pool->acquire(m_passthrough) : m_passthrough->makeInstance());
+
+        raw->setMessageCode(code);
+        return raw;
+    }
     else
     {
         O3D_WARNING(String("Undefined net message type [") << code << "]");
         return new GenericMessageIn();
     }
 }
-
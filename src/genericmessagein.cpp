@@ -26,7 +26,7 @@ GenericMessageIn::~GenericMessageIn()
 {
 }
 
-void GenericMessageIn::setMessageSize(UInt16 dataSize)
+void GenericMessageIn::setMessageSize(UInt32 dataSize)
 {
     m_messageDataSize = dataSize;
     m_rest = m_messageDataSize;
@@ -36,10 +36,10 @@ NetMessage* GenericMessageIn::readFromBuffer(NetBuffer* buffer)
 {
 //    O3D_MESSAGE("Read GenericMessageIn");
 
-    if (buffer->getAvailable() < m_rest)
+    if ((UInt32)buffer->getAvailable() < m_rest)
     {
-        Int16 len = buffer->getAvailable();
-        m_rest -= buffer->getAvailable();
+        UInt32 len = buffer->getAvailable();
+        m_rest -= len;
 
         if (len > 0)
             buffer->setPosition(buffer->getPosition() + len);
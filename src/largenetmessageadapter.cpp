@@ -0,0 +1,216 @@
+/**
+ * @file largenetmessageadapter.cpp
+ * @brief Read/write adapter for messages larger than 64KB, with optional streaming.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+#include <o3d/core/architecture.h>
+
+#include "o3d/net/largenetmessageadapter.h"
+#include "o3d/net/netbuffer.h"
+#include "o3d/net/netcodec.h"
+#include <o3d/core/debug.h>
+
+using namespace o3d;
+using namespace o3d::net;
+
+NetMessage* AbstractNetMessageStreamIn::readFromBuffer(NetBuffer *buffer)
+{
+    readChunk(buffer, 0, m_messageDataSize);
+    m_received = m_messageDataSize;
+
+    return nullptr;
+}
+
+void AbstractNetMessageStreamIn::recycle()
+{
+    AbstractNetMessageIn::recycle();
+
+    m_received = 0;
+    m_streaming = False;
+}
+
+LargeNetMessageAdapter::LargeNetMessageAdapter(
+        Bool varIntSize,
+        Bool streaming,
+        UInt32 maxMessageSize) :
+    m_varIntSize(varIntSize),
+    m_streaming(streaming),
+    m_maxMessageSize(maxMessageSize)
+{
+}
+
+LargeNetMessageAdapter::~LargeNetMessageAdapter()
+{
+}
+
+NetMessage* LargeNetMessageAdapter::readFrom(NetBuffer* buffer, NetMessage* message)
+{
+    AbstractNetMessage* m = reinterpret_cast<AbstractNetMessage*>(message);
+
+    // only messages that accept chunks are streamed, the others are buffered
+    AbstractNetMessageStreamIn *stream = m_streaming ?
+                static_cast<AbstractNetMessageIn*>(message)->asStreamIn() : nullptr;
+
+    // the size is already read, continue with the next chunk
+    if (stream && stream->m_streaming)
+        return readChunk(buffer, stream);
+
+    UInt32 size = 0;
+
+    // the size, and the whole message data for a buffered message, must be available,
+    // else the message stay pending and the size is read again with more data
+    const UInt32 capacity = buffer->getAvailable() + buffer->getFree();
+    const UInt32 available = buffer->getAvailable();
+
+    buffer->mark();
+
+    if (m_varIntSize)
+    {
+        if (!buffer->tryReadVarUInt32(size))
+            return message;
+    }
+    else
+    {
+        if (!buffer->tryReadUInt32(size))
+            return message;
+    }
+
+    if (size > m_maxMessageSize)
+        O3D_ERROR(E_BufferException("Invalid message size"));
+
+    if (stream)
+    {
+        buffer->commit();
+
+        m->setMessageSize(size);
+        stream->m_streaming = True;
+        stream->m_received = 0;
+
+        return readChunk(buffer, stream);
+    }
+
+    // a message the buffer cannot hold would never be readable
+    const UInt32 header = available - buffer->getAvailable();
+    if ((UInt64)size + header > capacity)
+        O3D_ERROR(E_BufferException("Message larger than the read buffer"));
+
+    if (!buffer->ensureReadable(size))
+    {
+        buffer->rollback();
+        return message;
+    }
+
+    buffer->commit();
+
+    m->setMessageSize(size);
+    message->readFromBuffer(buffer);
+
+    return nullptr;
+}
+
+NetMessage* LargeNetMessageAdapter::readChunk(NetBuffer *buffer, AbstractNetMessageStreamIn *message)
+{
+    const UInt32 rest = message->getMessageSize() - message->m_received;
+    const UInt32 available = buffer->getAvailable();
+    const UInt32 size = available < rest ? available : rest;
+
+    if (size > 0)
+    {
+        message->readChunk(buffer, message->m_received, size);
+        message->m_received += size;
+    }
+
+    if (message->m_received < message->getMessageSize())
+        return message;
+
+    message->m_streaming = False;
+    return nullptr;
+}
+
+NetMessage* LargeNetMessageAdapter::writeTo(NetBuffer* buffer, NetMessage* message)
+{
+    AbstractNetMessage* m = reinterpret_cast<AbstractNetMessage*>(message);
+    UInt32 size = m->getMessageSize();
+
+    if (size > m_maxMessageSize)
+        O3D_ERROR(E_BufferOverflow("Message size overflow"));
+
+    // a message the buffer cannot hold would be returned again and again
+    if ((UInt64)size + MAX_HEADER_SIZE > (UInt64)(UInt32)(buffer->getAvailable() + buffer->getFree()))
+        O3D_ERROR(E_BufferOverflow("Message larger than the write buffer"));
+
+    // we need at least size + 4 (or 5 for a varint) bytes of message size + [1..4] bytes of message code
+    if ((UInt64)(UInt32)buffer->getFree() < (UInt64)size + MAX_HEADER_SIZE)
+    {
+        return message;
+    }
+
+    const UInt32 frameStart = buffer->getLimit();
+    buffer->beginFrame();
+
+    DefaultNetMessageAdapter::writeMessageCode(buffer, m->getMessageCode());
+
+    // size, a declared size is written as a minimal varint, else the slot is
+    // reserved and patched once the message is serialized
+    const Bool patchSize = !m_varIntSize || (size == 0);
+    UInt32 sizeSlot = 0;
+
+    if (patchSize)
+        sizeSlot = buffer->reserve(m_varIntSize ? 5 : 4);
+    else
+        buffer->writeVarUInt32(size);
+
+    UInt32 start = buffer->getLimit();
+
+    // a partial frame must never be sent
+    try
+    {
+        message->writeToBuffer(buffer);
+    }
+    catch (...)
+    {
+        buffer->setLimit(frameStart);
+        buffer->rollbackFrame();
+        throw;
+    }
+
+    UInt32 stop = buffer->getLimit();
+
+    if (patchSize)
+    {
+        const UInt32 dataSize = stop - start;
+
+        // drop the partial frame before throwing
+        if (dataSize > m_maxMessageSize)
+        {
+            buffer->setLimit(frameStart);
+            buffer->rollbackFrame();
+            O3D_ERROR(E_BufferOverflow("Message size overflow"));
+        }
+
+        if (m_varIntSize)
+        {
+            UInt8 data[5];
+            NetVarInt::encodePadded(data, dataSize, 5);
+
+            buffer->patch(sizeSlot, data, 5);
+        }
+        else
+        {
+            buffer->patchUInt32(sizeSlot, dataSize);
+        }
+    }
+    else if ((stop - start) != size)
+    {
+        O3D_WARNING(String("Invalid Message Size detected ") << m->getDump() << " " << (stop - start) << " " << size);
+    }
+
+    buffer->commitFrame();
+
+    return nullptr;
+}
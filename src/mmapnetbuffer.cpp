@@ -0,0 +1,321 @@
+/**
+ * @file mmapnetbuffer.cpp
+ * @brief Buffer on top of a memory-mapped file, for spooling very large payloads.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/mmapnetbuffer.h"
+#include <o3d/core/debug.h>
+
+#ifdef O3D_WINDOWS
+#include <o3d/core/architecture.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#endif
+
+using namespace o3d;
+using namespace o3d::net;
+
+MmapNetBuffer::MmapNetBuffer(UInt32 capacity, const String &directory) :
+    MmapNetBuffer(mapTemporary(capacity, directory), False)
+{
+}
+
+MmapNetBuffer::MmapNetBuffer(const String &filename, OpenMode mode, UInt32 capacity) :
+    MmapNetBuffer(mapFile(filename, mode, capacity), mode == OPEN_READ)
+{
+}
+
+MmapNetBuffer::MmapNetBuffer(const Mapping &mapping, Bool readable) :
+    ArrayNetBuffer(mapping.data, mapping.size),
+    m_mapping(mapping),
+    m_released(0)
+{
+    if (readable)
+        setLimit(mapping.size);
+}
+
+MmapNetBuffer::~MmapNetBuffer()
+{
+    unmap(m_mapping);
+}
+
+Int32 MmapNetBuffer::getFree() const
+{
+    return m_mapping.size - getLimit();
+}
+
+void MmapNetBuffer::compact()
+{
+    const UInt32 position = getPosition();
+
+    if (position == getLimit())
+    {
+        // fully drained, rewind, the released pages are zero filled or reloaded on demand
+        releasePages(position);
+
+        setPosition(0);
+        setLimit(0);
+
+        m_released = 0;
+    }
+    else
+    {
+        // never move the data
+        releasePages(position);
+    }
+}
+
+#ifndef O3D_WINDOWS
+
+static UInt32 pageSize()
+{
+    static const UInt32 size = (UInt32)sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+static UInt8* mapDescriptor(int fd, UInt32 size, int flags)
+{
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+
+    // the mapping keeps the file alive
+    ::close(fd);
+
+    if (addr == MAP_FAILED)
+        O3D_ERROR(E_BufferException("Unable to map the file"));
+
+    return (UInt8*)addr;
+}
+
+MmapNetBuffer::Mapping MmapNetBuffer::mapTemporary(UInt32 capacity, const String &directory)
+{
+    if ((capacity == 0) || (capacity > 0x7FFFFFFF))
+        O3D_ERROR(E_InvalidParameter("Capacity must be in ]0..2GB["));
+
+    CString dir = directory.toUtf8();
+    const char *base = dir.length() > 0 ? dir.getData() : getenv("TMPDIR");
+    if ((base == nullptr) || (base[0] == 0))
+        base = "/tmp";
+
+    std::vector<char> path(strlen(base) + 32);
+    snprintf(path.data(), path.size(), "%s/o3dnet-mmapXXXXXX", base);
+
+    int fd = mkstemp(path.data());
+    if (fd < 0)
+        O3D_ERROR(E_BufferException("Unable to create the temporary file"));
+
+    // anonymous, removed once unmapped
+    unlink(path.data());
+
+    if (ftruncate(fd, capacity) != 0)
+    {
+        ::close(fd);
+        O3D_ERROR(E_BufferException("Unable to size the temporary file"));
+    }
+
+    Mapping mapping = { mapDescriptor(fd, capacity, MAP_SHARED), capacity, nullptr };
+    return mapping;
+}
+
+MmapNetBuffer::Mapping MmapNetBuffer::mapFile(const String &filename, OpenMode mode, UInt32 capacity)
+{
+    CString path = filename.toUtf8();
+
+    if (mode == OPEN_READ)
+    {
+        int fd = ::open(path.getData(), O_RDONLY);
+        if (fd < 0)
+            O3D_ERROR(E_BufferException("Unable to open the file"));
+
+        struct stat st;
+        if ((fstat(fd, &st) != 0) || (st.st_size == 0) || (st.st_size > 0x7FFFFFFF))
+        {
+            ::close(fd);
+            O3D_ERROR(E_BufferException("The file must be in ]0..2GB["));
+        }
+
+        // private copy on write mapping, the file is never modified
+        Mapping mapping = { mapDescriptor(fd, (UInt32)st.st_size, MAP_PRIVATE), (UInt32)st.st_size, nullptr };
+        return mapping;
+    }
+    else
+    {
+        if ((capacity == 0) || (capacity > 0x7FFFFFFF))
+            O3D_ERROR(E_InvalidParameter("Capacity must be in ]0..2GB["));
+
+        int fd = ::open(path.getData(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            O3D_ERROR(E_BufferException("Unable to create the file"));
+
+        if (ftruncate(fd, capacity) != 0)
+        {
+            ::close(fd);
+            O3D_ERROR(E_BufferException("Unable to size the file"));
+        }
+
+        Mapping mapping = { mapDescriptor(fd, capacity, MAP_SHARED), capacity, nullptr };
+        return mapping;
+    }
+}
+
+void MmapNetBuffer::unmap(Mapping &mapping)
+{
+    if (mapping.data)
+    {
+        munmap(mapping.data, mapping.size);
+        mapping.data = nullptr;
+    }
+}
+
+void MmapNetBuffer::releasePages(UInt32 offset)
+{
+    // whole pages only
+    const UInt32 end = offset & ~(pageSize() - 1);
+    if (end > m_released)
+    {
+        madvise(m_mapping.data + m_released, end - m_released, MADV_DONTNEED);
+        m_released = end;
+    }
+}
+
+#else
+
+static UInt8* mapHandle(HANDLE file, UInt32 size, Bool copyOnWrite, void *&handleOut)
+{
+    HANDLE handle = CreateFileMappingW(
+                file,
+                nullptr,
+                copyOnWrite ? PAGE_WRITECOPY : PAGE_READWRITE,
+                0,
+                size,
+                nullptr);
+
+    // the mapping keeps the file alive
+    CloseHandle(file);
+
+    if (handle == nullptr)
+        O3D_ERROR(E_BufferException("Unable to map the file"));
+
+    void *addr = MapViewOfFile(handle, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_WRITE, 0, 0, size);
+    if (addr == nullptr)
+    {
+        CloseHandle(handle);
+        O3D_ERROR(E_BufferException("Unable to map the file"));
+    }
+
+    handleOut = handle;
+    return (UInt8*)addr;
+}
+
+MmapNetBuffer::Mapping MmapNetBuffer::mapTemporary(UInt32 capacity, const String &directory)
+{
+    if ((capacity == 0) || (capacity > 0x7FFFFFFF))
+        O3D_ERROR(E_InvalidParameter("Capacity must be in ]0..2GB["));
+
+    WCHAR dir[MAX_PATH];
+    if (directory.isEmpty())
+        GetTempPathW(MAX_PATH, dir);
+    else
+        wcsncpy(dir, directory.getData(), MAX_PATH - 1), dir[MAX_PATH - 1] = 0;
+
+    WCHAR path[MAX_PATH];
+    if (GetTempFileNameW(dir, L"o3d", 0, path) == 0)
+        O3D_ERROR(E_BufferException("Unable to create the temporary file"));
+
+    // anonymous, removed once unmapped
+    HANDLE file = CreateFileW(
+                path,
+                GENERIC_READ | GENERIC_WRITE,
+                0,
+                nullptr,
+                CREATE_ALWAYS,
+                FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+        O3D_ERROR(E_BufferException("Unable to create the temporary file"));
+
+    Mapping mapping = { nullptr, capacity, nullptr };
+    mapping.data = mapHandle(file, capacity, False, mapping.handle);
+    return mapping;
+}
+
+MmapNetBuffer::Mapping MmapNetBuffer::mapFile(const String &filename, OpenMode mode, UInt32 capacity)
+{
+    if (mode == OPEN_READ)
+    {
+        HANDLE file = CreateFileW(
+                    filename.getData(),
+                    GENERIC_READ,
+                    FILE_SHARE_READ,
+                    nullptr,
+                    OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL,
+                    nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+            O3D_ERROR(E_BufferException("Unable to open the file"));
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || (size.QuadPart == 0) || (size.QuadPart > 0x7FFFFFFF))
+        {
+            CloseHandle(file);
+            O3D_ERROR(E_BufferException("The file must be in ]0..2GB["));
+        }
+
+        // copy on write mapping, the file is never modified
+        Mapping mapping = { nullptr, (UInt32)size.QuadPart, nullptr };
+        mapping.data = mapHandle(file, mapping.size, True, mapping.handle);
+        return mapping;
+    }
+    else
+    {
+        if ((capacity == 0) || (capacity > 0x7FFFFFFF))
+            O3D_ERROR(E_InvalidParameter("Capacity must be in ]0..2GB["));
+
+        HANDLE file = CreateFileW(
+                    filename.getData(),
+                    GENERIC_READ | GENERIC_WRITE,
+                    0,
+                    nullptr,
+                    CREATE_ALWAYS,
+                    FILE_ATTRIBUTE_NORMAL,
+                    nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+            O3D_ERROR(E_BufferException("Unable to create the file"));
+
+        Mapping mapping = { nullptr, capacity, nullptr };
+        mapping.data = mapHandle(file, capacity, False, mapping.handle);
+        return mapping;
+    }
+}
+
+void MmapNetBuffer::unmap(Mapping &mapping)
+{
+    if (mapping.data)
+    {
+        UnmapViewOfFile(mapping.data);
+        CloseHandle((HANDLE)mapping.handle);
+
+        mapping.data = nullptr;
+        mapping.handle = nullptr;
+    }
+}
+
+void MmapNetBuffer::releasePages(UInt32 offset)
+{
+    // the working set is trimmed by the system
+    m_released = offset;
+}
+
+#endif // O3D_WINDOWS
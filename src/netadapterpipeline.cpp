@@ -0,0 +1,332 @@
+/**
+ * @file netadapterpipeline.cpp
+ * @brief Read/write adapter chaining transform stages over the message frames.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+#include <o3d/core/architecture.h>
+
+#include "o3d/net/netadapterpipeline.h"
+#include "o3d/net/netbuffer.h"
+#include "o3d/net/netcodec.h"
+#include <o3d/core/debug.h>
+
+using namespace o3d;
+using namespace o3d::net;
+
+namespace {
+
+struct Crc32Table
+{
+    UInt32 table[256];
+
+    Crc32Table()
+    {
+        for (UInt32 i = 0; i < 256; ++i)
+        {
+            UInt32 c = i;
+            for (UInt32 k = 0; k < 8; ++k)
+            {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+
+            table[i] = c;
+        }
+    }
+};
+
+const Crc32Table ms_crc32Table;
+
+} // anonymous namespace
+
+NetAdapterStage::~NetAdapterStage()
+{
+}
+
+UInt32 NetAdapterStage::getMaxEncodedSize(UInt32 size) const
+{
+    return size;
+}
+
+//
+// NetChecksumStage
+//
+UInt32 NetChecksumStage::crc32(const UInt8 *data, UInt32 size)
+{
+    UInt32 c = 0xffffffff;
+
+    for (UInt32 i = 0; i < size; ++i)
+    {
+        c = ms_crc32Table.table[(c ^ data[i]) & 0xff] ^ (c >> 8);
+    }
+
+    return c ^ 0xffffffff;
+}
+
+Bool NetChecksumStage::encode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out)
+{
+    out.resize(size + 4);
+
+    if (size > 0)
+        memcpy(out.data(), data, size);
+
+    LittleEndianCodec::store<UInt32>(out.data() + size, crc32(data, size));
+
+    return True;
+}
+
+UInt32 NetChecksumStage::getMaxEncodedSize(UInt32 size) const
+{
+    return size + 4;
+}
+
+void NetChecksumStage::decode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out)
+{
+    if (size < 4)
+        O3D_ERROR(E_BufferException("Invalid frame checksum"));
+
+    size -= 4;
+
+    if (LittleEndianCodec::load<UInt32>(data + size) != crc32(data, size))
+        O3D_ERROR(E_BufferException("Invalid frame checksum"));
+
+    out.resize(size);
+
+    if (size > 0)
+        memcpy(out.data(), data, size);
+}
+
+//
+// NetAdapterPipeline
+//
+NetAdapterPipeline::NetAdapterPipeline()
+{
+    m_scratch = new ArrayNetBuffer(MAX_FRAME_SIZE);
+}
+
+NetAdapterPipeline::~NetAdapterPipeline()
+{
+    deletePtr(m_scratch);
+
+    for (NetAdapterStage *stage : m_stages)
+    {
+        deletePtr(stage);
+    }
+}
+
+void NetAdapterPipeline::addStage(NetAdapterStage *stage)
+{
+    O3D_CHECKPTR(stage);
+
+    if (m_stages.size() >= MAX_STAGES)
+        O3D_ERROR(E_InvalidParameter("Too many pipeline stages"));
+
+    m_stages.push_back(stage);
+}
+
+Bool NetAdapterPipeline::isShareable() const
+{
+    return False;
+}
+
+NetMessage* NetAdapterPipeline::readFrom(NetBuffer* buffer, NetMessage* message)
+{
+    AbstractNetMessage* m = reinterpret_cast<AbstractNetMessage*>(message);
+
+    // the header and the whole frame must be available
+    buffer->mark();
+
+    UInt8 stages = 0;
+    UInt32 size = 0;
+
+    if (!buffer->tryReadUInt8(stages) || !buffer->tryReadVarUInt32(size))
+    {
+        buffer->rollback();
+        return message;
+    }
+
+    if (size > MAX_FRAME_SIZE)
+        O3D_ERROR(E_BufferException("Invalid message size"));
+
+    if ((stages >> m_stages.size()) != 0)
+        O3D_ERROR(E_BufferException("Invalid pipeline stages"));
+
+    if (!buffer->ensureReadable(size))
+    {
+        buffer->rollback();
+        return message;
+    }
+
+    buffer->commit();
+
+    // passed through by every stage, read in place
+    if (stages == 0)
+    {
+        m->setMessageSize(size);
+        message->readFromBuffer(buffer);
+
+        return nullptr;
+    }
+
+    // the frame directly from the read buffer if contiguous, else gathered
+    UInt32 spanSize = 0;
+    const UInt8 *data = buffer->getReadableSpan(spanSize);
+    const Bool inPlace = spanSize >= size;
+
+    Int32 current = 0;
+
+    if (!inPlace)
+    {
+        std::vector<UInt8> &frame = m_frames[current];
+        frame.resize(size);
+
+        UInt32 offset = 0;
+        while (offset < size)
+        {
+            UInt32 n = 0;
+            const UInt8 *span = buffer->getReadableSpan(n);
+            n = std::min(n, size - offset);
+
+            memcpy(frame.data() + offset, span, n);
+            buffer->skip(n);
+
+            offset += n;
+        }
+
+        data = frame.data();
+        current = 1;
+    }
+
+    UInt32 n = size;
+
+    for (Int32 i = (Int32)m_stages.size() - 1; i >= 0; --i)
+    {
+        if ((stages & (1 << i)) == 0)
+            continue;
+
+        std::vector<UInt8> &out = m_frames[current];
+        m_stages[i]->decode(data, n, out);
+
+        if (out.size() > MAX_FRAME_SIZE)
+            O3D_ERROR(E_BufferException("Invalid message size"));
+
+        data = out.data();
+        n = (UInt32)out.size();
+        current ^= 1;
+    }
+
+    if (inPlace)
+        buffer->skip(size);
+
+    // the message reads the decoded frame in place
+    static UInt8 empty = 0;
+
+    ArrayNetBuffer frame(n > 0 ? const_cast<UInt8*>(data) : &empty, n);
+    frame.setByteOrder(buffer->getByteOrder());
+    frame.setStringTable(buffer->getStringTable());
+    frame.setLimit(n);
+
+    m->setMessageSize(n);
+    message->readFromBuffer(&frame);
+
+    return nullptr;
+}
+
+NetMessage* NetAdapterPipeline::writeTo(NetBuffer* buffer, NetMessage* message)
+{
+    AbstractNetMessage* m = reinterpret_cast<AbstractNetMessage*>(message);
+    UInt32 size = m->getMessageSize();
+
+    if (size > MAX_FRAME_SIZE)
+        O3D_ERROR(E_BufferOverflow("Message size overflow"));
+
+    // we need at least size + 1 byte of stages + 3 bytes of size + [1..4] bytes of message code
+    if ((UInt32)buffer->getFree() < size + 8)
+    {
+        return message;
+    }
+
+    m_scratch->setPosition(0);
+    m_scratch->setLimit(0);
+    m_scratch->setByteOrder(buffer->getByteOrder());
+    m_scratch->setStringTable(buffer->getStringTable());
+
+    // the slots defined by the message are kept only once its frame is written
+    m_scratch->beginFrame();
+
+    try
+    {
+        message->writeToBuffer(m_scratch);
+    }
+    catch (...)
+    {
+        m_scratch->rollbackFrame();
+        throw;
+    }
+
+    UInt32 n = m_scratch->getAvailable();
+    const UInt8 *data = m_scratch->getBuffer();
+
+    // the worst case must fit before any stage updates its state
+    UInt32 maxSize = n;
+    for (NetAdapterStage *stage : m_stages)
+    {
+        maxSize = stage->getMaxEncodedSize(maxSize);
+    }
+
+    if (maxSize > MAX_FRAME_SIZE)
+    {
+        m_scratch->rollbackFrame();
+        O3D_ERROR(E_BufferOverflow("Message size overflow"));
+    }
+
+    if ((UInt32)buffer->getFree() < maxSize + 8)
+    {
+        m_scratch->rollbackFrame();
+        return message;
+    }
+
+    UInt8 stages = 0;
+    Int32 current = 0;
+
+    for (UInt32 i = 0; i < m_stages.size(); ++i)
+    {
+        std::vector<UInt8> &out = m_frames[current];
+
+        if (m_stages[i]->encode(data, n, out))
+        {
+            stages |= static_cast<UInt8>(1 << i);
+
+            data = out.data();
+            n = (UInt32)out.size();
+            current ^= 1;
+        }
+    }
+
+    if (n > maxSize)
+    {
+        m_scratch->rollbackFrame();
+        O3D_ERROR(E_BufferOverflow("Encoded message overflow"));
+    }
+
+    DefaultNetMessageAdapter::writeMessageCode(buffer, m->getMessageCode());
+
+    buffer->writeUInt8(stages);
+    buffer->writeVarUInt32(n);
+
+    if (n > 0)
+        buffer->write(data, n);
+
+    m_scratch->commitFrame();
+
+    if ((size > 0) && (m_scratch->getAvailable() != (Int32)size))
+    {
+        O3D_WARNING(String("Invalid Message Size detected ") << m->getDump() << " " << m_scratch->getAvailable() << " " << size);
+    }
+
+    return nullptr;
+}
@@ -10,15 +10,519 @@
 #include "o3d/net/precompiled.h"
 
 #include "o3d/net/netbuffer.h"
+#include "o3d/net/netbufferarena.h"
+#include "o3d/net/netcodec.h"
+#include "o3d/net/netstringtable.h"
 #include <o3d/core/debug.h>
 
 using namespace o3d;
 using namespace o3d::net;
 
+NetBuffer::~NetBuffer()
+{
+}
+
+UInt32 NetBuffer::getReadableSegments(NetBufferSegment *segments, UInt32 max)
+{
+	if (max == 0)
+		return 0;
+
+	segments[0].data = getReadableSpan(segments[0].size);
+	return segments[0].size > 0 ? 1 : 0;
+}
+
+UInt32 NetBuffer::getWritableSegments(NetBufferSegment *segments, UInt32 max)
+{
+	if (max == 0)
+		return 0;
+
+	segments[0].data = getWritableSpan(segments[0].size);
+	return segments[0].size > 0 ? 1 : 0;
+}
+
+UInt32 NetBuffer::reserve(UInt32 size)
+{
+	static const UInt8 zeros[16] = { 0 };
+	const UInt32 handle = getLimit();
+
+	while (size > 0)
+	{
+		const UInt32 len = size < 16 ? size : 16;
+		write(zeros, len);
+		size -= len;
+	}
+
+	return handle;
+}
+
+void NetBuffer::patchUInt16(UInt32 handle, UInt16 value)
+{
+	UInt8 data[2];
+
+	if (getByteOrder() == System::ORDER_BIG_ENDIAN)
+		BigEndianCodec::store<UInt16>(data, value);
+	else
+		LittleEndianCodec::store<UInt16>(data, value);
+
+	patch(handle, data, 2);
+}
+
+void NetBuffer::patchUInt32(UInt32 handle, UInt32 value)
+{
+	UInt8 data[4];
+
+	if (getByteOrder() == System::ORDER_BIG_ENDIAN)
+		BigEndianCodec::store<UInt32>(data, value);
+	else
+		LittleEndianCodec::store<UInt32>(data, value);
+
+	patch(handle, data, 4);
+}
+
+void NetBuffer::writeElements(const UInt8 *data, UInt32 count, UInt32 elementSize)
+{
+	if ((UInt64)count * elementSize > (UInt64)getFree())
+	{
+		O3D_ERROR(E_BufferOverflow("Write overflow"));
+	}
+
+	const Bool swap = getByteOrder() != System::getNativeByteOrder();
+	UInt8 element[8];
+
+	while (count > 0)
+	{
+		UInt32 size = 0;
+		UInt8 *span = getWritableSpan(size);
+
+		UInt32 n = size / elementSize;
+		if (n > count)
+			n = count;
+
+		if (n > 0)
+		{
+			copyElements(span, data, n, elementSize, swap);
+			extend(n * elementSize);
+		}
+		else
+		{
+			// the element straddles two spans
+			n = 1;
+			copyElements(element, data, 1, elementSize, swap);
+			write(element, elementSize);
+		}
+
+		data += n * elementSize;
+		count -= n;
+	}
+}
+
+void NetBuffer::readElements(UInt8 *data, UInt32 count, UInt32 elementSize)
+{
+	if ((UInt64)count * elementSize > (UInt64)getAvailable())
+	{
+		O3D_ERROR(E_BufferOverflow("Read overflow"));
+	}
+
+	const Bool swap = getByteOrder() != System::getNativeByteOrder();
+	UInt8 element[8];
+
+	while (count > 0)
+	{
+		UInt32 size = 0;
+		UInt8 *span = getReadableSpan(size);
+
+		UInt32 n = size / elementSize;
+		if (n > count)
+			n = count;
+
+		if (n > 0)
+		{
+			copyElements(data, span, n, elementSize, swap);
+			skip(n * elementSize);
+		}
+		else
+		{
+			// the element straddles two spans
+			n = 1;
+			read(element, elementSize);
+			copyElements(data, element, 1, elementSize, swap);
+		}
+
+		data += n * elementSize;
+		count -= n;
+	}
+}
+
+void NetBuffer::writeVarUInt32(UInt32 value)
+{
+	writeVarInt(value);
+}
+
+void NetBuffer::writeVarUInt64(UInt64 value)
+{
+	writeVarInt(value);
+}
+
+void NetBuffer::writeVarInt32(Int32 value)
+{
+	writeVarInt(NetVarInt::zigZag32(value));
+}
+
+void NetBuffer::writeVarInt64(Int64 value)
+{
+	writeVarInt(NetVarInt::zigZag64(value));
+}
+
+UInt32 NetBuffer::readVarUInt32()
+{
+	UInt64 value = readVarInt();
+	if (value > 0xffffffffull)
+	{
+		O3D_ERROR(E_BufferException("Malformed varint"));
+	}
+
+	return static_cast<UInt32>(value);
+}
+
+UInt64 NetBuffer::readVarUInt64()
+{
+	return readVarInt();
+}
+
+Int32 NetBuffer::readVarInt32()
+{
+	return NetVarInt::unZigZag32(readVarUInt32());
+}
+
+Int64 NetBuffer::readVarInt64()
+{
+	return NetVarInt::unZigZag64(readVarInt());
+}
+
+Bool NetBuffer::readUTF8View(NetStringView &view)
+{
+	view.m_data = nullptr;
+	view.m_length = 0;
+
+	if (getAvailable() < 2)
+		return False;
+
+	Int16 size = readInt16();
+	if ((getAvailable() < size) || (size <= 0))
+		return True;
+
+	readUTF8Data(view, size);
+	return True;
+}
+
+void NetBuffer::readUTF8Data(NetStringView &view, UInt32 size)
+{
+	view.m_data = nullptr;
+	view.m_length = 0;
+
+	if (size == 0)
+		return;
+
+	UInt32 spanSize = 0;
+	UInt8 *span = getReadableSpan(spanSize);
+
+	if (spanSize >= size)
+	{
+		view.m_data = reinterpret_cast<const Char*>(span);
+		skip(size);
+	}
+	else
+	{
+		// straddles two segments
+		view.m_copy.resize(size);
+		memcpy(view.m_copy.data(), span, spanSize);
+
+		skip(spanSize);
+		readElements(reinterpret_cast<UInt8*>(view.m_copy.data() + spanSize), size - spanSize, 1);
+
+		view.m_data = view.m_copy.data();
+	}
+
+	view.m_length = size;
+}
+
+NetFrameListener::~NetFrameListener()
+{
+}
+
+void NetBuffer::beginFrame()
+{
+	if (m_stringTable != nullptr)
+		m_stringTable->mark();
+
+	m_inFrame = True;
+	m_frameListeners.clear();
+}
+
+void NetBuffer::commitFrame()
+{
+	if (m_stringTable != nullptr)
+		m_stringTable->commit();
+
+	m_inFrame = False;
+
+	for (NetFrameListener *listener : m_frameListeners)
+	{
+		listener->frameCommitted();
+	}
+
+	m_frameListeners.clear();
+}
+
+void NetBuffer::rollbackFrame()
+{
+	if (m_stringTable != nullptr)
+		m_stringTable->rollback();
+
+	m_inFrame = False;
+
+	for (NetFrameListener *listener : m_frameListeners)
+	{
+		listener->frameDropped();
+	}
+
+	m_frameListeners.clear();
+}
+
+void NetBuffer::addFrameListener(NetFrameListener *listener)
+{
+	if (m_inFrame)
+		m_frameListeners.push_back(listener);
+	else
+		listener->frameCommitted();
+}
+
+void NetBuffer::writeInternedUTF8(const String &string)
+{
+	CString utf8 = string.toUtf8();
+	writeInternedUTF8(utf8.getData(), utf8.length());
+}
+
+void NetBuffer::writeInternedUTF8(const Char *string)
+{
+	writeInternedUTF8(string, (UInt32)strlen(string));
+}
+
+void NetBuffer::writeInternedUTF8(const Char *string, UInt32 length)
+{
+	if (length > 0xffff)
+	{
+		O3D_ERROR(E_BufferException("String too long"));
+	}
+
+	// header is 0 for a literal, 2*id+1 for a slot definition, 2*id+2 for a slot reference
+	UInt32 slot = NetStringTable::NO_SLOT;
+	Bool defined = False;
+
+	if (m_stringTable != nullptr)
+		slot = m_stringTable->intern(string, length, defined);
+
+	if ((slot != NetStringTable::NO_SLOT) && !defined)
+	{
+		writeVarUInt32(slot * 2 + 2);
+		return;
+	}
+
+	writeVarUInt32(slot != NetStringTable::NO_SLOT ? slot * 2 + 1 : 0);
+	writeUInt16(static_cast<UInt16>(length));
+	write(reinterpret_cast<const UInt8*>(string), length);
+}
+
+Bool NetBuffer::readInternedUTF8(String &string)
+{
+	const UInt32 position = getPosition();
+
+	UInt32 header = 0;
+	if (!tryReadVarUInt32(header))
+		return False;
+
+	if ((header != 0) && ((header & 1) == 0))
+	{
+		// reference to a slot, no allocation nor UTF-8 decoding
+		const String *interned = m_stringTable != nullptr ? m_stringTable->lookup((header - 2) >> 1) : nullptr;
+		if (interned == nullptr)
+		{
+			O3D_ERROR(E_BufferException("Unknown interned string"));
+		}
+
+		string = *interned;
+		return True;
+	}
+
+	UInt16 size = 0;
+	if (!tryReadUInt16(size) || ((UInt32)getAvailable() < size))
+	{
+		setPosition(position);
+		return False;
+	}
+
+	NetStringView view;
+	readUTF8Data(view, size);
+
+	if (header == 0)
+	{
+		if (m_stringTable != nullptr)
+			m_stringTable->countLiteral();
+
+		string = view.toString();
+		return True;
+	}
+
+	const UInt32 slot = header >> 1;
+	if ((m_stringTable == nullptr) || (slot >= m_stringTable->getCapacity()))
+	{
+		O3D_ERROR(E_BufferException("Interned string out of the string table"));
+	}
+
+	string = m_stringTable->define(slot, view.getData(), view.length());
+	return True;
+}
+
+void NetBuffer::rollback()
+{
+	if (getPosition() != m_readMark)
+		setPosition(m_readMark);
+}
+
+Bool NetBuffer::tryReadVarUInt32(UInt32 &value)
+{
+	UInt64 value64 = 0;
+	if (!tryReadVarUInt64(value64))
+		return False;
+
+	if (value64 > 0xffffffffull)
+	{
+		O3D_ERROR(E_BufferException("Malformed varint"));
+	}
+
+	value = static_cast<UInt32>(value64);
+	return True;
+}
+
+Bool NetBuffer::tryReadVarUInt64(UInt64 &value)
+{
+	// a complete varint is either 10 bytes long or ends with a byte lesser than 0x80
+	const UInt32 available = getAvailable();
+	if (available == 0)
+		return False;
+
+	if (available >= NetVarInt::MAX_SIZE64)
+	{
+		value = readVarInt();
+		return True;
+	}
+
+	UInt32 size = 0;
+	const UInt8 *span = getReadableSpan(size);
+
+	UInt32 len = 0;
+	while ((len < size) && (span[len] & 0x80))
+	{
+		++len;
+	}
+
+	if (len < size)
+	{
+		value = readVarInt();
+		return True;
+	}
+
+	// straddles two segments, check byte by byte and restore the position
+	const UInt32 position = getPosition();
+	UInt8 byte = 0x80;
+
+	for (UInt32 i = 0; (i < available) && (byte & 0x80); ++i)
+	{
+		byte = readUInt8();
+	}
+
+	setPosition(position);
+
+	if (byte & 0x80)
+		return False;
+
+	value = readVarInt();
+	return True;
+}
+
+void NetBuffer::writeVarInt(UInt64 value)
+{
+	UInt32 size = 0;
+	UInt8 *span = getWritableSpan(size);
+
+	if (size >= NetVarInt::MAX_SIZE64)
+	{
+		extend(NetVarInt::encode(span, value));
+	}
+	else
+	{
+		UInt8 data[NetVarInt::MAX_SIZE64];
+		write(data, NetVarInt::encode(data, value));
+	}
+}
+
+UInt64 NetBuffer::readVarInt()
+{
+	UInt32 size = 0;
+	const UInt8 *span = getReadableSpan(size);
+	UInt64 value = 0;
+
+	// fast path, the longest varint is in the span
+	if (size >= NetVarInt::MAX_SIZE64)
+	{
+		const UInt32 len = NetVarInt::decodeFast(span, value);
+		if (len == 0)
+		{
+			O3D_ERROR(E_BufferException("Malformed varint"));
+		}
+
+		skip(len);
+		return value;
+	}
+
+	// check first that the varint is complete, to not consume a partial one
+	UInt32 len = 0;
+	while (len < size && (span[len] & 0x80))
+	{
+		++len;
+	}
+
+	if (len < size)
+	{
+		for (UInt32 i = 0; i <= len; ++i)
+		{
+			value |= static_cast<UInt64>(span[i] & 0x7f) << (7 * i);
+		}
+
+		skip(len + 1);
+		return value;
+	}
+
+	// straddles two spans (or incomplete)
+	for (UInt32 shift = 0; shift < 64; shift += 7)
+	{
+		const UInt8 byte = readUInt8();
+		value |= static_cast<UInt64>(byte & 0x7f) << shift;
+
+		if (byte < 0x80)
+		{
+			return value;
+		}
+	}
+
+	O3D_ERROR(E_BufferException("Malformed varint"));
+}
+
 ArrayNetBuffer::ArrayNetBuffer(UInt8* array, UInt32 size)
 {
 	O3D_CHECKPTR(array);
 	m_wrapped = True;
+	m_arena = nullptr;
 	m_array = array;
 	m_size = size;
 	m_readPosition = 0;
@@ -30,6 +534,7 @@ ArrayNetBuffer::ArrayNetBuffer(UInt8* array, UInt32 size)
 ArrayNetBuffer::ArrayNetBuffer(UInt32 size)
 {
 	m_wrapped = False;
+	m_arena = nullptr;
 	m_array = new UInt8[size];
 	m_size = size;
 	m_readPosition = 0;
@@ -38,12 +543,48 @@ ArrayNetBuffer::ArrayNetBuffer(UInt32 size)
 	setByteOrder(System::getNativeByteOrder());
 }
 
+ArrayNetBuffer::ArrayNetBuffer(NetBufferArena *arena)
+{
+	O3D_CHECKPTR(arena);
+	m_wrapped = True;
+	m_arena = arena;
+	m_array = arena->acquire();
+	m_size = arena->getBlockSize();
+	m_readPosition = 0;
+	m_writePosition = 0;
+
+	setByteOrder(System::getNativeByteOrder());
+}
+
 ArrayNetBuffer::~ArrayNetBuffer()
 {
 	if (!m_wrapped)
 	{
 		deleteArray(m_array);
 	}
+	else if (m_arena)
+	{
+		m_arena->release(m_array);
+	}
+}
+
+// Native load and store using the codec of the buffer byte order
+template <class T>
+inline void ArrayNetBuffer::store(UInt8 *data, T value) const
+{
+	if (m_byteOrder == System::ORDER_BIG_ENDIAN)
+		BigEndianCodec::store<T>(data, value);
+	else
+		LittleEndianCodec::store<T>(data, value);
+}
+
+template <class T>
+inline T ArrayNetBuffer::load(const UInt8 *data) const
+{
+	if (m_byteOrder == System::ORDER_BIG_ENDIAN)
+		return BigEndianCodec::load<T>(data);
+	else
+		return LittleEndianCodec::load<T>(data);
 }
 
 void ArrayNetBuffer::writeInt8(Int8 value)
@@ -54,22 +595,22 @@ void ArrayNetBuffer::writeInt8(Int8 value)
 	}
 	else
 	{
-		m_array[m_writePosition] = value;
-		m_writePosition++;
+		store<UInt8>(m_array + m_writePosition, static_cast<UInt8>(value));
+		m_writePosition += 1;
 	}
 }
 
 void ArrayNetBuffer::writeUInt8(UInt8 value)
 {
-    if (m_writePosition+1 > m_size)
-    {
-        O3D_ERROR(E_BufferOverflow("Write overflow"));
-    }
-    else
-    {
-        m_array[m_writePosition] = value;
-        m_writePosition++;
-    }
+	if (m_writePosition+1 > m_size)
+	{
+		O3D_ERROR(E_BufferOverflow("Write overflow"));
+	}
+	else
+	{
+		store<UInt8>(m_array + m_writePosition, static_cast<UInt8>(value));
+		m_writePosition += 1;
+	}
 }
 
 void ArrayNetBuffer::writeInt16(Int16 value)
@@ -80,43 +621,22 @@ void ArrayNetBuffer::writeInt16(Int16 value)
 	}
 	else
 	{
-		if (m_swap)
-		{
-			m_array[m_writePosition+1] = static_cast<UInt8>(*reinterpret_cast<UInt16*>(&value));
-            m_array[m_writePosition]   = static_cast<UInt8>(*reinterpret_cast<UInt16*>(&value) >> 8);
-		}
-		else
-		{
-            m_array[m_writePosition]   = static_cast<UInt8>(*reinterpret_cast<UInt16*>(&value));
-			m_array[m_writePosition+1] = static_cast<UInt8>(*reinterpret_cast<UInt16*>(&value) >> 8);
-		}
-
+		store<UInt16>(m_array + m_writePosition, static_cast<UInt16>(value));
 		m_writePosition += 2;
 	}
 }
 
-
 void ArrayNetBuffer::writeUInt16(UInt16 value)
 {
-    if (m_writePosition+2 > m_size)
-    {
-        O3D_ERROR(E_BufferOverflow("Write overflow"));
-    }
-    else
-    {
-        if (m_swap)
-        {
-            m_array[m_writePosition+1] = static_cast<UInt8>(value);
-            m_array[m_writePosition]   = static_cast<UInt8>(value >> 8);
-        }
-        else
-        {
-            m_array[m_writePosition]   = static_cast<UInt8>(value);
-            m_array[m_writePosition+1] = static_cast<UInt8>(value >> 8);
-        }
-
-        m_writePosition += 2;
-    }
+	if (m_writePosition+2 > m_size)
+	{
+		O3D_ERROR(E_BufferOverflow("Write overflow"));
+	}
+	else
+	{
+		store<UInt16>(m_array + m_writePosition, static_cast<UInt16>(value));
+		m_writePosition += 2;
+	}
 }
 
 void ArrayNetBuffer::writeInt32(Int32 value)
@@ -127,50 +647,22 @@ void ArrayNetBuffer::writeInt32(Int32 value)
 	}
 	else
 	{
-		if (m_swap)
-		{
-			m_array[m_writePosition+3] = static_cast<UInt8>(*reinterpret_cast<UInt32*>(&value));
-			m_array[m_writePosition+2] = static_cast<UInt8>(*reinterpret_cast<UInt32*>(&value) >> 8);
-			m_array[m_writePosition+1] = static_cast<UInt8>(*reinterpret_cast<UInt32*>(&value) >> 16);
-			m_array[m_writePosition]   = static_cast<UInt8>(*reinterpret_cast<UInt32*>(&value) >> 24);
-		}
-		else
-		{
-            m_array[m_writePosition]   = static_cast<UInt8>(*reinterpret_cast<UInt32*>(&value));
-			m_array[m_writePosition+1] = static_cast<UInt8>(*reinterpret_cast<UInt32*>(&value) >> 8);
-			m_array[m_writePosition+2] = static_cast<UInt8>(*reinterpret_cast<UInt32*>(&value) >> 16);
-			m_array[m_writePosition+3] = static_cast<UInt8>(*reinterpret_cast<UInt32*>(&value) >> 24);
-		}
-
+		store<UInt32>(m_array + m_writePosition, static_cast<UInt32>(value));
 		m_writePosition += 4;
 	}
 }
 
 void ArrayNetBuffer::writeUInt32(UInt32 value)
 {
-    if (m_writePosition+4 > m_size)
-    {
-        O3D_ERROR(E_BufferOverflow("Write overflow"));
-    }
-    else
-    {
-        if (m_swap)
-        {
-            m_array[m_writePosition+3] = static_cast<UInt8>(value);
-            m_array[m_writePosition+2] = static_cast<UInt8>(value >> 8);
-            m_array[m_writePosition+1] = static_cast<UInt8>(value >> 16);
-            m_array[m_writePosition]   = static_cast<UInt8>(value >> 24);
-        }
-        else
-        {
-            m_array[m_writePosition]   = static_cast<UInt8>(value);
-            m_array[m_writePosition+1] = static_cast<UInt8>(value >> 8);
-            m_array[m_writePosition+2] = static_cast<UInt8>(value >> 16);
-            m_array[m_writePosition+3] = static_cast<UInt8>(value >> 24);
-        }
-
-        m_writePosition += 4;
-    }
+	if (m_writePosition+4 > m_size)
+	{
+		O3D_ERROR(E_BufferOverflow("Write overflow"));
+	}
+	else
+	{
+		store<UInt32>(m_array + m_writePosition, static_cast<UInt32>(value));
+		m_writePosition += 4;
+	}
 }
 
 void ArrayNetBuffer::writeInt64(Int64 value)
@@ -181,87 +673,47 @@ void ArrayNetBuffer::writeInt64(Int64 value)
 	}
 	else
 	{
-		if (m_swap)
-		{
-			m_array[m_writePosition+7] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value));
-			m_array[m_writePosition+6] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 8);
-			m_array[m_writePosition+5] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 16);
-			m_array[m_writePosition+4] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 24);
-			m_array[m_writePosition+3] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 32);
-			m_array[m_writePosition+2] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 40);
-			m_array[m_writePosition+1] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 48);
-			m_array[m_writePosition]   = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 56);
-		}
-		else
-		{
-            m_array[m_writePosition]   = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value));
-			m_array[m_writePosition+1] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 8);
-			m_array[m_writePosition+2] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 16);
-			m_array[m_writePosition+3] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 24);
-			m_array[m_writePosition+4] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 32);
-			m_array[m_writePosition+5] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 40);
-			m_array[m_writePosition+6] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 48);
-			m_array[m_writePosition+7] = static_cast<UInt8>(*reinterpret_cast<UInt64*>(&value) >> 56);
-		}
-
+		store<UInt64>(m_array + m_writePosition, static_cast<UInt64>(value));
 		m_writePosition += 8;
 	}
 }
 
 void ArrayNetBuffer::writeUInt64(UInt64 value)
 {
-    if (m_writePosition+8 > m_size)
-    {
-        O3D_ERROR(E_BufferOverflow("Write overflow"));
-    }
-    else
-    {
-        if (m_swap)
-        {
-            m_array[m_writePosition+7] = static_cast<UInt8>(value);
-            m_array[m_writePosition+6] = static_cast<UInt8>(value >> 8);
-            m_array[m_writePosition+5] = static_cast<UInt8>(value >> 16);
-            m_array[m_writePosition+4] = static_cast<UInt8>(value >> 24);
-            m_array[m_writePosition+3] = static_cast<UInt8>(value >> 32);
-            m_array[m_writePosition+2] = static_cast<UInt8>(value >> 40);
-            m_array[m_writePosition+1] = static_cast<UInt8>(value >> 48);
-            m_array[m_writePosition]   = static_cast<UInt8>(value >> 56);
-        }
-        else
-        {
-            m_array[m_writePosition] = static_cast<UInt8>(value);
-            m_array[m_writePosition+1] = static_cast<UInt8>(value >> 8);
-            m_array[m_writePosition+2] = static_cast<UInt8>(value >> 16);
-            m_array[m_writePosition+3] = static_cast<UInt8>(value >> 24);
-            m_array[m_writePosition+4] = static_cast<UInt8>(value >> 32);
-            m_array[m_writePosition+5] = static_cast<UInt8>(value >> 40);
-            m_array[m_writePosition+6] = static_cast<UInt8>(value >> 48);
-            m_array[m_writePosition+7] = static_cast<UInt8>(value >> 56);
-        }
-
-        m_writePosition += 8;
-    }
+	if (m_writePosition+8 > m_size)
+	{
+		O3D_ERROR(E_BufferOverflow("Write overflow"));
+	}
+	else
+	{
+		store<UInt64>(m_array + m_writePosition, static_cast<UInt64>(value));
+		m_writePosition += 8;
+	}
 }
 
 void ArrayNetBuffer::writeUTF8(const String &string)
 {
     CString utf8 = string.toUtf8();
-
-    Int32 length = utf8.length();
-    writeInt16((Int16)length);
-    for (int i = 0; i < length; i++)
-    {
-        writeInt8(utf8[i]);
-    }
+    writeUTF8(utf8.getData(), utf8.length());
 }
 
 void ArrayNetBuffer::writeUTF8(const Char* string)
 {
-	Int32 length = strlen(string);
-	writeInt16((Int16)length);
-	for (int i = 0; i < length; i++)
+	writeUTF8(string, (UInt32)strlen(string));
+}
+
+void ArrayNetBuffer::writeUTF8(const Char* string, UInt32 length)
+{
+	// length prefix and data at once
+	if (length + 2 > m_size - m_writePosition)
 	{
-		writeInt8(string[i]);
+		O3D_ERROR(E_BufferOverflow("Write overflow"));
+	}
+	else
+	{
+		store<UInt16>(m_array + m_writePosition, static_cast<UInt16>(length));
+		memcpy(m_array + m_writePosition + 2, string, length);
+		m_writePosition += length + 2;
 	}
 }
 void ArrayNetBuffer::writeBool(Bool value)
@@ -294,25 +746,25 @@ Int8 ArrayNetBuffer::readInt8()
 	}
 	else
 	{
-		Int8 value = m_array[m_readPosition];
-		m_readPosition++;
+		Int8 value = static_cast<Int8>(load<UInt8>(m_array + m_readPosition));
+		m_readPosition += 1;
 		return value;
 	}
 }
 
 UInt8 ArrayNetBuffer::readUInt8()
 {
-    if (m_readPosition+1 > m_writePosition)
-    {
-        O3D_ERROR(E_BufferOverflow("Read overflow"));
-        return 0; // Never reach
-    }
-    else
-    {
-        Int8 value = m_array[m_readPosition];
-        m_readPosition++;
-        return value;
-    }
+	if (m_readPosition+1 > m_writePosition)
+	{
+		O3D_ERROR(E_BufferOverflow("Read overflow"));
+		return 0; // Never reach
+	}
+	else
+	{
+		UInt8 value = static_cast<UInt8>(load<UInt8>(m_array + m_readPosition));
+		m_readPosition += 1;
+		return value;
+	}
 }
 
 Int16 ArrayNetBuffer::readInt16()
@@ -324,18 +776,7 @@ Int16 ArrayNetBuffer::readInt16()
 	}
 	else
 	{
-		Int16 value;
-		if (m_swap)
-		{
-			value = *reinterpret_cast<UInt16*>(&m_array[m_readPosition+1]) |
-					*reinterpret_cast<UInt16*>(&m_array[m_readPosition]) << 8;
-		}
-		else
-		{
-			value = *reinterpret_cast<UInt16*>(&m_array[m_readPosition]) |
-					*reinterpret_cast<UInt16*>(&m_array[m_readPosition+1]) << 8;
-		}
-
+		Int16 value = static_cast<Int16>(load<UInt16>(m_array + m_readPosition));
 		m_readPosition += 2;
 		return value;
 	}
@@ -343,28 +784,17 @@ Int16 ArrayNetBuffer::readInt16()
 
 UInt16 ArrayNetBuffer::readUInt16()
 {
-    if (m_readPosition+2 > m_writePosition)
-    {
-        O3D_ERROR(E_BufferOverflow("Read overflow"));
-        return 0; // Never reach
-    }
-    else
-    {
-        UInt16 value;
-        if (m_swap)
-        {
-            value = *reinterpret_cast<UInt16*>(&m_array[m_readPosition+1]) |
-                    *reinterpret_cast<UInt16*>(&m_array[m_readPosition]) << 8;
-        }
-        else
-        {
-            value = *reinterpret_cast<UInt16*>(&m_array[m_readPosition]) |
-                    *reinterpret_cast<UInt16*>(&m_array[m_readPosition+1]) << 8;
-        }
-
-        m_readPosition += 2;
-        return value;
-    }
+	if (m_readPosition+2 > m_writePosition)
+	{
+		O3D_ERROR(E_BufferOverflow("Read overflow"));
+		return 0; // Never reach
+	}
+	else
+	{
+		UInt16 value = static_cast<UInt16>(load<UInt16>(m_array + m_readPosition));
+		m_readPosition += 2;
+		return value;
+	}
 }
 
 Int32 ArrayNetBuffer::readInt32()
@@ -376,22 +806,7 @@ Int32 ArrayNetBuffer::readInt32()
 	}
 	else
 	{
-		Int32 value;
-		if (m_swap)
-		{
-			value = *reinterpret_cast<UInt32*>(&m_array[m_readPosition+3]) |
-					*reinterpret_cast<UInt32*>(&m_array[m_readPosition+2]) << 8 |
-					*reinterpret_cast<UInt32*>(&m_array[m_readPosition+1]) << 16 |
-					*reinterpret_cast<UInt32*>(&m_array[m_readPosition])   << 24;
-		}
-		else
-		{
-			value = *reinterpret_cast<UInt32*>(&m_array[m_readPosition]) |
-					*reinterpret_cast<UInt32*>(&m_array[m_readPosition+1]) << 8 |
-					*reinterpret_cast<UInt32*>(&m_array[m_readPosition+2]) << 16 |
-					*reinterpret_cast<UInt32*>(&m_array[m_readPosition+3]) << 24;
-		}
-
+		Int32 value = static_cast<Int32>(load<UInt32>(m_array + m_readPosition));
 		m_readPosition += 4;
 		return value;
 	}
@@ -399,32 +814,17 @@ Int32 ArrayNetBuffer::readInt32()
 
 UInt32 ArrayNetBuffer::readUInt32()
 {
-    if (m_readPosition+4 > m_writePosition)
-    {
-        O3D_ERROR(E_BufferOverflow("Read overflow"));
-        return 0; // Never reach
-    }
-    else
-    {
-        UInt32 value;
-        if (m_swap)
-        {
-            value = *reinterpret_cast<UInt32*>(&m_array[m_readPosition+3]) |
-                    *reinterpret_cast<UInt32*>(&m_array[m_readPosition+2]) << 8 |
-                    *reinterpret_cast<UInt32*>(&m_array[m_readPosition+1]) << 16 |
-                    *reinterpret_cast<UInt32*>(&m_array[m_readPosition])   << 24;
-        }
-        else
-        {
-            value = *reinterpret_cast<UInt32*>(&m_array[m_readPosition]) |
-                    *reinterpret_cast<UInt32*>(&m_array[m_readPosition+1]) << 8 |
-                    *reinterpret_cast<UInt32*>(&m_array[m_readPosition+2]) << 16 |
-                    *reinterpret_cast<UInt32*>(&m_array[m_readPosition+3]) << 24;
-        }
-
-        m_readPosition += 4;
-        return value;
-    }
+	if (m_readPosition+4 > m_writePosition)
+	{
+		O3D_ERROR(E_BufferOverflow("Read overflow"));
+		return 0; // Never reach
+	}
+	else
+	{
+		UInt32 value = static_cast<UInt32>(load<UInt32>(m_array + m_readPosition));
+		m_readPosition += 4;
+		return value;
+	}
 }
 
 Int64 ArrayNetBuffer::readInt64()
@@ -436,30 +836,7 @@ Int64 ArrayNetBuffer::readInt64()
 	}
 	else
 	{
-		Int64 value;
-		if (m_swap)
-		{
-			value = *reinterpret_cast<UInt64*>(&m_array[m_readPosition+7]) |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+6]) << 8 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+5]) << 16 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+4]) << 24 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+3]) << 32 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+2]) << 40 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+1]) << 48 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition])   << 56;
-		}
-		else
-		{
-			value = *reinterpret_cast<UInt64*>(&m_array[m_readPosition]) |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+1]) << 8 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+2]) << 16 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+3]) << 24 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+4]) << 32 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+5]) << 40 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+6]) << 48 |
-					*reinterpret_cast<UInt64*>(&m_array[m_readPosition+7]) << 56;
-		}
-
+		Int64 value = static_cast<Int64>(load<UInt64>(m_array + m_readPosition));
 		m_readPosition += 8;
 		return value;
 	}
@@ -467,40 +844,17 @@ Int64 ArrayNetBuffer::readInt64()
 
 UInt64 ArrayNetBuffer::readUInt64()
 {
-    if (m_readPosition+8 > m_writePosition)
-    {
-        O3D_ERROR(E_BufferOverflow("Read overflow"));
-        return 0; // Never reach
-    }
-    else
-    {
-        UInt64 value;
-        if (m_swap)
-        {
-            value = *reinterpret_cast<UInt64*>(&m_array[m_readPosition+7]) |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+6]) << 8 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+5]) << 16 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+4]) << 24 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+3]) << 32 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+2]) << 40 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+1]) << 48 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition])   << 56;
-        }
-        else
-        {
-            value = *reinterpret_cast<UInt64*>(&m_array[m_readPosition]) |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+1]) << 8 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+2]) << 16 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+3]) << 24 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+4]) << 32 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+5]) << 40 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+6]) << 48 |
-                    *reinterpret_cast<UInt64*>(&m_array[m_readPosition+7]) << 56;
-        }
-
-        m_readPosition += 8;
-        return value;
-    }
+	if (m_readPosition+8 > m_writePosition)
+	{
+		O3D_ERROR(E_BufferOverflow("Read overflow"));
+		return 0; // Never reach
+	}
+	else
+	{
+		UInt64 value = static_cast<UInt64>(load<UInt64>(m_array + m_readPosition));
+		m_readPosition += 8;
+		return value;
+	}
 }
 
 Bool ArrayNetBuffer::read(UInt8* buffer, Int16 size)
@@ -515,6 +869,34 @@ Bool ArrayNetBuffer::read(UInt8* buffer, Int16 size)
 	return False;
 }
 
+void ArrayNetBuffer::writeElements(const UInt8 *data, UInt32 count, UInt32 elementSize)
+{
+	if ((UInt64)count * elementSize > m_size - m_writePosition)
+	{
+		O3D_ERROR(E_BufferOverflow("Write overflow"));
+	}
+	else
+	{
+		copyElements(m_array + m_writePosition, data, count, elementSize,
+					 m_byteOrder != System::getNativeByteOrder());
+		m_writePosition += count * elementSize;
+	}
+}
+
+void ArrayNetBuffer::readElements(UInt8 *data, UInt32 count, UInt32 elementSize)
+{
+	if ((UInt64)count * elementSize > m_writePosition - m_readPosition)
+	{
+		O3D_ERROR(E_BufferOverflow("Read overflow"));
+	}
+	else
+	{
+		copyElements(data, m_array + m_readPosition, count, elementSize,
+					 m_byteOrder != System::getNativeByteOrder());
+		m_readPosition += count * elementSize;
+	}
+}
+
 Bool ArrayNetBuffer::readUTF8(Char* string, Int16 size)
 {
 	if (getAvailable() >= 2)
@@ -579,6 +961,54 @@ UInt8* ArrayNetBuffer::getBuffer()
 	return m_array;
 }
 
+UInt8* ArrayNetBuffer::getReadableSpan(UInt32 &size)
+{
+	size = m_writePosition - m_readPosition;
+	return m_array + m_readPosition;
+}
+
+UInt8* ArrayNetBuffer::getWritableSpan(UInt32 &size)
+{
+	size = m_size - m_writePosition;
+	return m_array + m_writePosition;
+}
+
+void ArrayNetBuffer::skip(UInt32 size)
+{
+	if (size > m_writePosition - m_readPosition)
+	{
+		O3D_ERROR(E_BufferOverflow("Read overflow"));
+	}
+	else
+	{
+		m_readPosition += size;
+	}
+}
+
+void ArrayNetBuffer::extend(UInt32 size)
+{
+	if (size > m_size - m_writePosition)
+	{
+		O3D_ERROR(E_BufferOverflow("Write overflow"));
+	}
+	else
+	{
+		m_writePosition += size;
+	}
+}
+
+void ArrayNetBuffer::patch(UInt32 handle, const UInt8 *data, UInt32 size)
+{
+	if ((handle > m_writePosition) || (size > m_writePosition - handle))
+	{
+		O3D_ERROR(E_BufferOverflow("Patch overflow"));
+	}
+	else
+	{
+		memcpy(m_array + handle, data, size);
+	}
+}
+
 UInt32 ArrayNetBuffer::getLimit() const
 {
 	return m_writePosition;
@@ -586,7 +1016,7 @@ UInt32 ArrayNetBuffer::getLimit() const
 
 void ArrayNetBuffer::setLimit(UInt32 limit)
 {
-	if (limit < m_size)
+	if (limit <= m_size)
 	{
 		m_writePosition = limit;
 	}
@@ -603,7 +1033,7 @@ UInt32 ArrayNetBuffer::getPosition() const
 
 void ArrayNetBuffer::setPosition(UInt32 position)
 {
-	if (position >= m_size)
+	if (position > m_size)
 	{
 		O3D_ERROR(E_BufferOverflow("Position overflow"));
 	}
@@ -622,12 +1052,13 @@ void ArrayNetBuffer::compact()
 	if ((m_writePosition > m_readPosition) && (m_readPosition > 0))
 	{
 		// move data unread to the beginning of the array
-		memcpy(m_array, m_array + m_readPosition, m_writePosition - m_readPosition);
+		memmove(m_array, m_array + m_readPosition, m_writePosition - m_readPosition);
 		m_writePosition -= m_readPosition;
 		m_readPosition = 0;
 	}
-	else
+	else if (m_writePosition <= m_readPosition)
 	{
+		// everything consumed, unread data already at the beginning is kept
 		m_writePosition = 0;
 		m_readPosition = 0;
 	}
@@ -641,7 +1072,6 @@ void ArrayNetBuffer::flip()
 void ArrayNetBuffer::setByteOrder(System::ByteOrder order)
 {
 	m_byteOrder = order;
-	m_swap = m_byteOrder != System::getNativeByteOrder();
 }
 
 System::ByteOrder ArrayNetBuffer::getByteOrder() const
@@ -0,0 +1,172 @@
+/**
+ * @file netbufferarena.cpp
+ * @brief Fixed-size buffer blocks carved out of huge pages.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/netbufferarena.h"
+#include "o3d/net/netbuffer.h"
+#include <o3d/core/debug.h>
+
+#ifdef O3D_WINDOWS
+#include <o3d/core/architecture.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace o3d;
+using namespace o3d::net;
+
+NetBufferArena::NetBufferArena(UInt32 blockSize, UInt32 maxChunks) :
+    m_blockSize(blockSize),
+    m_maxChunks(maxChunks),
+    m_carved(CHUNK_SIZE)
+{
+    if ((blockSize == 0) || ((blockSize & (blockSize - 1)) != 0) || (blockSize > CHUNK_SIZE))
+        O3D_ERROR(E_InvalidParameter("Block size must be a power of two up to 2MB"));
+}
+
+NetBufferArena::~NetBufferArena()
+{
+    for (Chunk &chunk : m_chunks)
+    {
+        unmapChunk(chunk);
+    }
+}
+
+UInt8* NetBufferArena::acquire()
+{
+    FastMutexLocker locker(m_mutex);
+
+    if (!m_free.empty())
+    {
+        UInt8 *block = m_free.back();
+        m_free.pop_back();
+
+        return block;
+    }
+
+    // last chunk is entirely carved, map a new one
+    if (m_carved == CHUNK_SIZE)
+    {
+        if ((m_maxChunks > 0) && (m_chunks.size() >= m_maxChunks))
+            O3D_ERROR(E_BufferOverflow("Arena is full"));
+
+        m_chunks.push_back(mapChunk());
+        m_carved = 0;
+    }
+
+    UInt8 *block = m_chunks.back().data + m_carved;
+    m_carved += m_blockSize;
+
+    return block;
+}
+
+void NetBufferArena::release(UInt8 *block)
+{
+    FastMutexLocker locker(m_mutex);
+    m_free.push_back(block);
+}
+
+UInt32 NetBufferArena::getNumChunks() const
+{
+    FastMutexLocker locker(m_mutex);
+    return (UInt32)m_chunks.size();
+}
+
+UInt32 NetBufferArena::getNumHugeChunks() const
+{
+    FastMutexLocker locker(m_mutex);
+
+    UInt32 count = 0;
+    for (const Chunk &chunk : m_chunks)
+    {
+        if (chunk.huge)
+            ++count;
+    }
+
+    return count;
+}
+
+#ifndef O3D_WINDOWS
+
+NetBufferArena::Chunk NetBufferArena::mapChunk()
+{
+    Chunk chunk = { nullptr, CHUNK_SIZE, nullptr, False };
+    void *addr = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    // reserved huge pages (vm.nr_hugepages), often none
+    addr = mmap(nullptr, CHUNK_SIZE, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (addr != MAP_FAILED)
+    {
+        chunk.data = (UInt8*)addr;
+        chunk.base = addr;
+        chunk.huge = True;
+
+        return chunk;
+    }
+#endif
+
+    // twice the size to align the chunk on a huge page boundary
+    chunk.size = CHUNK_SIZE * 2;
+    addr = mmap(nullptr, chunk.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (addr == MAP_FAILED)
+        O3D_ERROR(E_BufferException("Unable to map an arena chunk"));
+
+    chunk.base = addr;
+    chunk.data = (UInt8*)(((size_t)addr + CHUNK_SIZE - 1) & ~(size_t)(CHUNK_SIZE - 1));
+
+#ifdef MADV_HUGEPAGE
+    // transparent huge pages, when enabled in madvise or always mode
+    chunk.huge = madvise(chunk.data, CHUNK_SIZE, MADV_HUGEPAGE) == 0;
+#endif
+
+    return chunk;
+}
+
+void NetBufferArena::unmapChunk(Chunk &chunk)
+{
+    munmap(chunk.base, chunk.size);
+    chunk.data = nullptr;
+}
+
+#else
+
+NetBufferArena::Chunk NetBufferArena::mapChunk()
+{
+    Chunk chunk = { nullptr, CHUNK_SIZE, nullptr, False };
+
+    // large pages need the SeLockMemoryPrivilege
+    const SIZE_T largePage = GetLargePageMinimum();
+    if ((largePage > 0) && (CHUNK_SIZE % largePage == 0))
+    {
+        chunk.base = VirtualAlloc(nullptr, CHUNK_SIZE, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        chunk.huge = chunk.base != nullptr;
+    }
+
+    if (chunk.base == nullptr)
+        chunk.base = VirtualAlloc(nullptr, CHUNK_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+    if (chunk.base == nullptr)
+        O3D_ERROR(E_BufferException("Unable to map an arena chunk"));
+
+    chunk.data = (UInt8*)chunk.base;
+    return chunk;
+}
+
+void NetBufferArena::unmapChunk(Chunk &chunk)
+{
+    VirtualFree(chunk.base, 0, MEM_RELEASE);
+    chunk.data = nullptr;
+}
+
+#endif // O3D_WINDOWS
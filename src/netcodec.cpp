@@ -0,0 +1,234 @@
+/**
+ * @file netcodec.cpp
+ * @brief Byte swapping of arrays, using SSE2, SSSE3 or AVX2 when available.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/netcodec.h"
+
+// SSE2 is the baseline on x86-64
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define O3D_NET_SSE2
+    #include <emmintrin.h>
+#endif
+
+// SSSE3 and AVX2 versions are compiled apart and selected at runtime
+#if defined(O3D_NET_SSE2) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+    #define O3D_NET_SIMD_DISPATCH
+    #include <immintrin.h>
+#endif
+
+using namespace o3d;
+using namespace o3d::net;
+
+namespace {
+
+template <class T>
+inline void scalarSwap(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    for (UInt32 i = 0; i < count; ++i)
+    {
+        T value;
+        memcpy(&value, src + i * sizeof(T), sizeof(T));
+        value = byteSwap(value);
+        memcpy(dst + i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+#ifdef O3D_NET_SSE2
+inline __m128i sse2Swap16(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+void sse2SwapArray16(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    UInt32 i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), sse2Swap16(v));
+    }
+
+    scalarSwap<UInt16>(dst + i * 2, src + i * 2, count - i);
+}
+
+void sse2SwapArray32(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    UInt32 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+
+        // swap the 16 bits words of each element, then the bytes of each word
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), sse2Swap16(v));
+    }
+
+    scalarSwap<UInt32>(dst + i * 4, src + i * 4, count - i);
+}
+
+void sse2SwapArray64(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    UInt32 i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 8));
+
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 8), sse2Swap16(v));
+    }
+
+    scalarSwap<UInt64>(dst + i * 8, src + i * 8, count - i);
+}
+#endif // O3D_NET_SSE2
+
+#ifdef O3D_NET_SIMD_DISPATCH
+// pshufb masks reversing the bytes of each element (per 128 bits lane),
+// _mm_set_epi8 takes the bytes from the highest to the lowest
+#define O3D_NET_MASK16 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1
+#define O3D_NET_MASK32 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3
+#define O3D_NET_MASK64 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7
+
+template <UInt32 SIZE>
+__attribute__((target("ssse3")))
+void ssse3SwapArray(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    const __m128i mask = SIZE == 2 ? _mm_set_epi8(O3D_NET_MASK16) :
+                        (SIZE == 4 ? _mm_set_epi8(O3D_NET_MASK32) : _mm_set_epi8(O3D_NET_MASK64));
+
+    const UInt32 step = 16 / SIZE;
+
+    UInt32 i = 0;
+    for (; i + step <= count; i += step)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * SIZE));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * SIZE), _mm_shuffle_epi8(v, mask));
+    }
+
+    for (; i < count; ++i)
+    {
+        for (UInt32 j = 0; j < SIZE; ++j)
+        {
+            dst[i * SIZE + j] = src[i * SIZE + SIZE - 1 - j];
+        }
+    }
+}
+
+template <UInt32 SIZE>
+__attribute__((target("avx2")))
+void avx2SwapArray(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    const __m256i mask = SIZE == 2 ? _mm256_set_epi8(O3D_NET_MASK16, O3D_NET_MASK16) :
+                        (SIZE == 4 ? _mm256_set_epi8(O3D_NET_MASK32, O3D_NET_MASK32) :
+                                     _mm256_set_epi8(O3D_NET_MASK64, O3D_NET_MASK64));
+
+    const UInt32 step = 32 / SIZE;
+
+    UInt32 i = 0;
+    for (; i + step <= count; i += step)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * SIZE));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * SIZE), _mm256_shuffle_epi8(v, mask));
+    }
+
+    ssse3SwapArray<SIZE>(dst + i * SIZE, src + i * SIZE, count - i);
+}
+
+#undef O3D_NET_MASK16
+#undef O3D_NET_MASK32
+#undef O3D_NET_MASK64
+#endif // O3D_NET_SIMD_DISPATCH
+
+typedef void (*SwapArrayFunc)(UInt8 *dst, const UInt8 *src, UInt32 count);
+
+struct SwapArrayFuncs
+{
+    SwapArrayFunc swap16;
+    SwapArrayFunc swap32;
+    SwapArrayFunc swap64;
+
+    SwapArrayFuncs()
+    {
+#if defined(O3D_NET_SIMD_DISPATCH)
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2"))
+        {
+            swap16 = avx2SwapArray<2>;
+            swap32 = avx2SwapArray<4>;
+            swap64 = avx2SwapArray<8>;
+        }
+        else if (__builtin_cpu_supports("ssse3"))
+        {
+            swap16 = ssse3SwapArray<2>;
+            swap32 = ssse3SwapArray<4>;
+            swap64 = ssse3SwapArray<8>;
+        }
+        else
+        {
+            swap16 = sse2SwapArray16;
+            swap32 = sse2SwapArray32;
+            swap64 = sse2SwapArray64;
+        }
+#elif defined(O3D_NET_SSE2)
+        swap16 = sse2SwapArray16;
+        swap32 = sse2SwapArray32;
+        swap64 = sse2SwapArray64;
+#else
+        swap16 = scalarSwap<UInt16>;
+        swap32 = scalarSwap<UInt32>;
+        swap64 = scalarSwap<UInt64>;
+#endif
+    }
+};
+
+// resolved once at load time
+const SwapArrayFuncs ms_swapArrayFuncs;
+
+} // anonymous namespace
+
+void o3d::net::byteSwapArray16(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    ms_swapArrayFuncs.swap16(dst, src, count);
+}
+
+void o3d::net::byteSwapArray32(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    ms_swapArrayFuncs.swap32(dst, src, count);
+}
+
+void o3d::net::byteSwapArray64(UInt8 *dst, const UInt8 *src, UInt32 count)
+{
+    ms_swapArrayFuncs.swap64(dst, src, count);
+}
+
+void o3d::net::copyElements(UInt8 *dst, const UInt8 *src, UInt32 count, UInt32 elementSize, Bool swap)
+{
+    if (!swap || (elementSize == 1))
+    {
+        memcpy(dst, src, count * elementSize);
+        return;
+    }
+
+    switch (elementSize)
+    {
+        case 2:
+            ms_swapArrayFuncs.swap16(dst, src, count);
+            break;
+        case 4:
+            ms_swapArrayFuncs.swap32(dst, src, count);
+            break;
+        case 8:
+            ms_swapArrayFuncs.swap64(dst, src, count);
+            break;
+        default:
+            O3D_ERROR(E_InvalidParameter("Element size must be 1, 2, 4 or 8"));
+    }
+}
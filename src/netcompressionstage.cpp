@@ -0,0 +1,351 @@
+/**
+ * @file netcompressionstage.cpp
+ * @brief Streaming LZ4-like compression stage, with a per connection history.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+#include <o3d/core/architecture.h>
+
+#include "o3d/net/netcompressionstage.h"
+#include "o3d/net/netbuffer.h"
+#include "o3d/net/netcodec.h"
+#include <o3d/core/debug.h>
+
+#include <algorithm>
+
+using namespace o3d;
+using namespace o3d::net;
+
+namespace {
+
+const UInt32 MIN_MATCH = 4;
+
+inline UInt32 load32(const UInt8 *data)
+{
+    UInt32 value;
+    memcpy(&value, data, 4);
+    return value;
+}
+
+inline UInt8* writeLength(UInt8 *op, UInt32 length)
+{
+    while (length >= 255)
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+
+    *op++ = static_cast<UInt8>(length);
+    return op;
+}
+
+inline UInt32 readLength(const UInt8 *&ip, const UInt8 *end)
+{
+    UInt32 length = 0;
+    UInt8 b;
+
+    do {
+        if (ip >= end)
+            O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+
+    return length;
+}
+
+//! Token, extended literal length, literals, and the match if length is not null.
+inline UInt8* writeSequence(
+        UInt8 *op,
+        const UInt8 *literals,
+        UInt32 numLiterals,
+        UInt32 offset,
+        UInt32 length)
+{
+    const UInt32 matchCode = length > 0 ? length - MIN_MATCH : 0;
+
+    *op++ = static_cast<UInt8>((std::min<UInt32>(numLiterals, 15) << 4) | std::min<UInt32>(matchCode, 15));
+
+    if (numLiterals >= 15)
+        op = writeLength(op, numLiterals - 15);
+
+    memcpy(op, literals, numLiterals);
+    op += numLiterals;
+
+    if (length > 0)
+    {
+        *op++ = static_cast<UInt8>(offset);
+        *op++ = static_cast<UInt8>(offset >> 8);
+
+        if (matchCode >= 15)
+            op = writeLength(op, matchCode - 15);
+    }
+
+    return op;
+}
+
+} // anonymous namespace
+
+UInt32 NetCompressionStage::History::prepare(UInt32 frameSize, UInt32 window)
+{
+    UInt32 shift = 0;
+
+    // bounded to twice the window plus the frame
+    if ((size > window) && (size + frameSize > 2 * window))
+    {
+        shift = size - window;
+        memmove(data.data(), data.data() + shift, window);
+        size = window;
+    }
+
+    if (data.size() < size + frameSize)
+        data.resize(size + frameSize);
+
+    return shift;
+}
+
+NetCompressionStage::NetCompressionStage(UInt32 minFrameSize, UInt32 windowSize) :
+    m_minFrameSize(std::max<UInt32>(minFrameSize, MIN_MATCH)),
+    m_window(windowSize),
+    m_encoderBase(0),
+    m_hashTable(nullptr)
+{
+    if ((windowSize == 0) || (windowSize > 0xffff))
+        O3D_ERROR(E_InvalidParameter("Window size must be in [1..65535]"));
+
+    m_encoder.size = 0;
+    m_decoder.size = 0;
+
+    memset(&m_stats, 0, sizeof(Stats));
+}
+
+NetCompressionStage::~NetCompressionStage()
+{
+    deleteArray(m_hashTable);
+}
+
+Float NetCompressionStage::getRatio() const
+{
+    if (m_stats.bytesOut == 0)
+        return 1.f;
+
+    return static_cast<Float>(static_cast<Double>(m_stats.bytesIn) / m_stats.bytesOut);
+}
+
+Bool NetCompressionStage::encode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out)
+{
+    ++m_stats.numFrames;
+    m_stats.bytesIn += size;
+
+    if (size < m_minFrameSize)
+    {
+        m_stats.bytesOut += size;
+        return False;
+    }
+
+    if (m_hashTable == nullptr)
+    {
+        m_hashTable = new UInt32[1 << HASH_BITS];
+        memset(m_hashTable, 0, sizeof(UInt32) << HASH_BITS);
+    }
+
+    // the hashed positions are absolute, so a shift has no need to rebase them
+    m_encoderBase += m_encoder.prepare(size, m_window);
+
+    // the frame follows the history, so matches can reference both
+    const UInt32 start = m_encoder.size;
+    memcpy(m_encoder.data.data() + start, data, size);
+
+    out.resize(NetVarInt::MAX_SIZE32 + size + size / 255 + 16);
+
+    UInt32 n = NetVarInt::encode(out.data(), size);
+    n += compress(start, start + size, out.data() + n);
+
+    if (n >= size)
+    {
+        // not added to the history, the decoder will not see it
+        m_stats.bytesOut += size;
+        return False;
+    }
+
+    m_encoder.size = start + size;
+    out.resize(n);
+
+    ++m_stats.numCompressed;
+    m_stats.bytesOut += n;
+
+    return True;
+}
+
+UInt32 NetCompressionStage::compress(UInt32 start, UInt32 end, UInt8 *out)
+{
+    const UInt8 *base = m_encoder.data.data();
+    UInt8 *op = out;
+
+    UInt32 anchor = start;
+    UInt32 ip = start;
+
+    while (ip + MIN_MATCH <= end)
+    {
+        const UInt32 sequence = load32(base + ip);
+        const UInt32 h = (sequence * 2654435761u) >> (32 - HASH_BITS);
+
+        // distance from the last same hashed position, modulo 2^32
+        const UInt32 distance = (m_encoderBase + ip) - m_hashTable[h];
+        m_hashTable[h] = m_encoderBase + ip;
+
+        // a stale position is rejected by the comparison, and the window bound keeps the
+        // match inside the history of the decoder
+        if ((distance > 0) && (distance <= m_window) && (distance <= ip) &&
+            (load32(base + ip - distance) == sequence))
+        {
+            UInt32 candidate = ip - distance;
+            UInt32 length = MIN_MATCH;
+
+#if !O3D_NET_NATIVE_BIG_ENDIAN
+            // 8 bytes at a time, the first different byte given by the lowest set bit
+            while (ip + length + 8 <= end)
+            {
+                UInt64 a, b;
+                memcpy(&a, base + ip + length, 8);
+                memcpy(&b, base + candidate + length, 8);
+
+                if (a != b)
+                {
+                    length += countTrailingZeros64(a ^ b) >> 3;
+                    break;
+                }
+
+                length += 8;
+            }
+
+            if ((ip + length + 8 > end))
+#endif
+            {
+                while ((ip + length < end) && (base[candidate + length] == base[ip + length]))
+                {
+                    ++length;
+                }
+            }
+
+            while ((ip > anchor) && (candidate > 0) && (base[ip - 1] == base[candidate - 1]))
+            {
+                --ip;
+                --candidate;
+                ++length;
+            }
+
+            op = writeSequence(op, base + anchor, ip - anchor, ip - candidate, length);
+
+            ip += length;
+            anchor = ip;
+        }
+        else
+        {
+            // skip faster through the incompressible data
+            ip += 1 + ((ip - anchor) >> 6);
+        }
+    }
+
+    // last literals
+    op = writeSequence(op, base + anchor, end - anchor, 0, 0);
+
+    return static_cast<UInt32>(op - out);
+}
+
+void NetCompressionStage::decode(const UInt8 *data, UInt32 size, std::vector<UInt8> &out)
+{
+    const UInt8 *ip = data;
+    const UInt8 *inEnd = data + size;
+
+    // frame size, at most 3 bytes
+    UInt32 frameSize = 0;
+    UInt32 bits = 0;
+    UInt8 b;
+
+    do {
+        if ((ip >= inEnd) || (bits > 14))
+            O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+        b = *ip++;
+        frameSize |= static_cast<UInt32>(b & 0x7f) << bits;
+        bits += 7;
+    } while (b & 0x80);
+
+    if (frameSize > NetAdapterPipeline::MAX_FRAME_SIZE)
+        O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+    m_decoder.prepare(frameSize, m_window);
+
+    UInt8 *base = m_decoder.data.data();
+    const UInt32 start = m_decoder.size;
+    const UInt32 end = start + frameSize;
+    UInt32 op = start;
+
+    for (;;)
+    {
+        if (ip >= inEnd)
+            O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+        const UInt8 token = *ip++;
+
+        UInt32 numLiterals = token >> 4;
+        if (numLiterals == 15)
+            numLiterals += readLength(ip, inEnd);
+
+        if ((numLiterals > (UInt32)(inEnd - ip)) || (numLiterals > end - op))
+            O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+        memcpy(base + op, ip, numLiterals);
+        op += numLiterals;
+        ip += numLiterals;
+
+        // the last sequence has no match
+        if (ip == inEnd)
+            break;
+
+        if (inEnd - ip < 2)
+            O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+        const UInt32 offset = ip[0] | (static_cast<UInt32>(ip[1]) << 8);
+        ip += 2;
+
+        if ((offset == 0) || (offset > op))
+            O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+        UInt32 length = (token & 15) + MIN_MATCH;
+        if ((token & 15) == 15)
+            length += readLength(ip, inEnd);
+
+        if (length > end - op)
+            O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+        const UInt8 *match = base + op - offset;
+
+        if (offset >= length)
+        {
+            memcpy(base + op, match, length);
+        }
+        else
+        {
+            // overlapping, repeats the last offset bytes
+            for (UInt32 i = 0; i < length; ++i)
+            {
+                base[op + i] = match[i];
+            }
+        }
+
+        op += length;
+    }
+
+    if (op != end)
+        O3D_ERROR(E_BufferException("Invalid compressed frame"));
+
+    m_decoder.size = end;
+    out.assign(base + start, base + end);
+}
@@ -0,0 +1,19 @@
+/**
+ * @file netdeltasnapshot.cpp
+ * @brief Delta encoding of entity states against per-session baselines.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/netdeltasnapshot.h"
+
+using namespace o3d;
+using namespace o3d::net;
+
+NetDeltaState::~NetDeltaState()
+{
+}
@@ -12,17 +12,19 @@
 
 #include "o3d/net/netmessageadapter.h"
 #include "o3d/net/netbuffer.h"
+#include "o3d/net/netcodec.h"
+#include "o3d/net/netmessagepool.h"
 #include <o3d/core/debug.h>
 
 using namespace o3d;
 using namespace o3d::net;
 
-UInt16 AbstractNetMessage::getMessageSize() const
+UInt32 AbstractNetMessage::getMessageSize() const
 {
     return m_messageDataSize;
 }
 
-void AbstractNetMessage::setMessageSize(UInt16 dataSize)
+void AbstractNetMessage::setMessageSize(UInt32 dataSize)
 {
     m_messageDataSize = dataSize;
 }
@@ -37,13 +39,28 @@ NetMessage* AbstractNetMessageIn::writeToBuffer(NetBuffer* buffer)
     return nullptr;
 }
 
+void AbstractNetMessageIn::release()
+{
+    if (m_pool)
+        m_pool->release(this);
+    else
+        delete this;
+}
+
+void AbstractNetMessageIn::recycle()
+{
+    m_messageDataSize = 0;
+    m_consume = 1;
+}
+
 
 NetMessage *AbstractNetMessageOut::readFromBuffer(NetBuffer *buffer)
 {
     return nullptr;
 }
 
-DefaultNetMessageAdapter::DefaultNetMessageAdapter()
+DefaultNetMessageAdapter::DefaultNetMessageAdapter(Bool varIntSize) :
+    m_varIntSize(varIntSize)
 {
 }
 
@@ -54,12 +71,41 @@ DefaultNetMessageAdapter::~DefaultNetMessageAdapter()
 NetMessage* DefaultNetMessageAdapter::readFrom(NetBuffer* buffer, NetMessage* message)
 {
     AbstractNetMessage* m = reinterpret_cast<AbstractNetMessage*> (message);
-    Int16 size = buffer->readInt16();
+    Int32 size = 0;
+
+    // the size and the whole message data must be available, else the message stay
+    // pending and the size is read again once more data are received
+    buffer->mark();
+
+    if (m_varIntSize)
+    {
+        UInt32 varSize = 0;
+        if (!buffer->tryReadVarUInt32(varSize))
+            return message;
+
+        if (varSize > 0xffff)
+            O3D_ERROR(E_BufferException("Invalid message size"));
+
+        size = static_cast<Int32>(varSize);
+    }
+    else
+    {
+        UInt16 size16 = 0;
+        if (!buffer->tryReadUInt16(size16))
+            return message;
+
+        size = size16;
+    }
 
     //O3D_MESSAGE(String("ReadMessage ") << m->getMessageCode() << " " << (Int32)size);
 
-    if (buffer->getAvailable() < size)
-        return nullptr;
+    if (!buffer->ensureReadable(size))
+    {
+        buffer->rollback();
+        return message;
+    }
+
+    buffer->commit();
 
     m->setMessageSize(size);
     message->readFromBuffer(buffer);
@@ -70,58 +116,126 @@ NetMessage* DefaultNetMessageAdapter::readFrom(NetBuffer* buffer, NetMessage* me
 NetMessage* DefaultNetMessageAdapter::writeTo(NetBuffer* buffer, NetMessage* message)
 {
     AbstractNetMessage* m = reinterpret_cast<AbstractNetMessage*>(message);
-    Int16 size = m->getMessageSize();
+    UInt32 size = m->getMessageSize();
 
-    // we need at laest size + 2 bytes of message size + [1..4] bytes of message code
-    if (buffer->getFree() < size + 6)
+    if (size > 0xffff)
+        O3D_ERROR(E_BufferOverflow("Message size overflow"));
+
+    // we need at laest size + 2 (or 3 for a varint) bytes of message size + [1..4] bytes of message code
+    if ((UInt32)buffer->getFree() < size + (m_varIntSize ? 7 : 6))
     {
         return message;
     }
 
-    // multi-byte message code (like for UTF8)
-    UInt32 c = m->getMessageCode();
+    const UInt32 frameStart = buffer->getLimit();
+    buffer->beginFrame();
+
+    writeMessageCode(buffer, m->getMessageCode());
+
+    // size, a declared size is written as a minimal varint, else the slot is
+    // reserved and patched once the message is serialized
+    const Bool patchSize = !m_varIntSize || (size == 0);
+    UInt32 sizeSlot = 0;
+
+    if (patchSize)
+        sizeSlot = buffer->reserve(m_varIntSize ? 3 : 2);
+    else
+        buffer->writeVarUInt32(size);
+
+    UInt32 start = buffer->getLimit();
+
+    // a partial frame must never be sent
+    try
+    {
+        message->writeToBuffer(buffer);
+    }
+    catch (...)
+    {
+        buffer->setLimit(frameStart);
+        buffer->rollbackFrame();
+        throw;
+    }
+
+    UInt32 stop = buffer->getLimit();
+
+    if (patchSize)
+    {
+        const UInt32 dataSize = stop - start;
+
+        // same limit as the declared size, drop the partial frame before throwing
+        if (dataSize > 0xffff)
+        {
+            buffer->setLimit(frameStart);
+            buffer->rollbackFrame();
+            O3D_ERROR(E_BufferOverflow("Message size overflow"));
+        }
+
+        if (m_varIntSize)
+        {
+            UInt8 data[3];
+            NetVarInt::encodePadded(data, dataSize, 3);
+
+            buffer->patch(sizeSlot, data, 3);
+        }
+        else
+        {
+            buffer->patchUInt16(sizeSlot, static_cast<UInt16>(dataSize));
+        }
+    }
+    else if ((stop - start) != size)
+    {
+        O3D_WARNING(String("Invalid Message Size detected ") << m->getDump() << " " << (stop - start) << " " << size);
+    }
+
+    buffer->commitFrame();
+
+    return nullptr;
+}
+
+void DefaultNetMessageAdapter::writeMessageCode(NetBuffer *buffer, UInt32 c)
+{
+    UInt8 data[4];
+    UInt32 len;
 
     if (c < 0x80)
     {
         // 0xxxxxxx
-        buffer->writeInt8(static_cast<Int8>(c));
+        data[0] = static_cast<UInt8>(c);
+        len = 1;
     }
     else if (c < 0x800)
     {
         // C0          80
         // 110xxxxx 10xxxxxx
-        buffer->writeInt8(static_cast<Int8>(0xC0 | (c >> 6)));
-        buffer->writeInt8(static_cast<Int8>(0x80 | (c & 0x3F)));
+        data[0] = static_cast<UInt8>(0xC0 | (c >> 6));
+        data[1] = static_cast<UInt8>(0x80 | (c & 0x3F));
+        len = 2;
     }
     else if (c < 0x8000)
     {
         // E0       80       80
         // 1110xxxx 10xxxxxx 10xxxxxx
-        buffer->writeInt8(static_cast<Int8>(0xE0 | (c >> 12)));
-        buffer->writeInt8(static_cast<Int8>(0x80 | (c >> 6 & 0x3F)));
-        buffer->writeInt8(static_cast<Int8>(0x80 | (c & 0x3F)));
+        data[0] = static_cast<UInt8>(0xE0 | (c >> 12));
+        data[1] = static_cast<UInt8>(0x80 | (c >> 6 & 0x3F));
+        data[2] = static_cast<UInt8>(0x80 | (c & 0x3F));
+        len = 3;
     }
-    else
+    else if (c <= MAX_MESSAGE_CODE)
     {
         // F0      80       80       80
         //11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-        buffer->writeInt8(static_cast<Int8>(0xF0 | (c >> 12) >> 6));
-        buffer->writeInt8(static_cast<Int8>(0x80 | (c >> 12 & 0x3F)));
-        buffer->writeInt8(static_cast<Int8>(0x80 | (c >> 6 & 0x1F)));
-        buffer->writeInt8(static_cast<Int8>(0x80 | (c & 0x3F)));
+        data[0] = static_cast<UInt8>(0xF0 | (c >> 18));
+        data[1] = static_cast<UInt8>(0x80 | (c >> 12 & 0x3F));
+        data[2] = static_cast<UInt8>(0x80 | (c >> 6 & 0x3F));
+        data[3] = static_cast<UInt8>(0x80 | (c & 0x3F));
+        len = 4;
+    }
+    else
+    {
+        O3D_ERROR(E_InvalidParameter("Message code overflow"));
     }
 
-    // size
-    buffer->writeInt16(size);
-
-    Int32 start = buffer->getLimit();
-    message->writeToBuffer(buffer);
-
-    Int32 stop = buffer->getLimit();
-    if ((stop - start) != size)
-        O3D_WARNING(String("Invalid Message Size detected ") << m->getDump() << " " << (stop - start) << " " << size);
-
-    return nullptr;
+    buffer->write(data, len);
 }
 
 Bool o3d::net::AbstractNetMessage::consume()
@@ -0,0 +1,90 @@
+/**
+ * @file netmessageframe.cpp
+ * @brief Message encoded once, shared by several sessions.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+#include <o3d/core/architecture.h>
+
+#include "o3d/net/netmessageframe.h"
+#include "o3d/net/netreadwriteadapter.h"
+#include "o3d/net/segmentednetbuffer.h"
+#include <o3d/core/debug.h>
+
+using namespace o3d;
+using namespace o3d::net;
+
+NetMessageFrame::NetMessageFrame(NetMessage *message, NetReadWriteAdapter *adapter, UInt32 refs) :
+    m_data(nullptr),
+    m_size(0),
+    m_refs(refs)
+{
+    O3D_CHECKPTR(message);
+
+    // a per connection state (compression history, batch) cannot be encoded once
+    if ((adapter != nullptr) && !adapter->isShareable())
+        O3D_ERROR(E_InvalidParameter("Frame adapter not shareable"));
+
+    SegmentedNetBuffer buffer;
+
+    NetMessage *rest = adapter != nullptr ?
+                adapter->writeTo(&buffer, message) : message->writeToBuffer(&buffer);
+
+    if (rest != nullptr)
+        O3D_ERROR(E_BufferOverflow("Message too large for a frame"));
+
+    m_size = buffer.getAvailable();
+    m_data = new UInt8[m_size > 0 ? m_size : 1];
+
+    // gather the segments into a single array
+    NetBufferSegment segments[16];
+    UInt32 offset = 0;
+
+    while (offset < m_size)
+    {
+        const UInt32 count = buffer.getReadableSegments(segments, 16);
+        UInt32 size = 0;
+
+        for (UInt32 i = 0; i < count; ++i)
+        {
+            memcpy(m_data + offset + size, segments[i].data, segments[i].size);
+            size += segments[i].size;
+        }
+
+        buffer.skip(size);
+        offset += size;
+    }
+}
+
+NetMessageFrame::~NetMessageFrame()
+{
+    deleteArray(m_data);
+}
+
+NetMessage *NetMessageFrame::readFromBuffer(NetBuffer *buffer)
+{
+    return nullptr;
+}
+
+NetMessage *NetMessageFrame::writeToBuffer(NetBuffer *buffer)
+{
+    if ((UInt32)buffer->getFree() < m_size)
+        return this;
+
+    buffer->write(m_data, m_size);
+    return nullptr;
+}
+
+Bool NetMessageFrame::isFramed() const
+{
+    return True;
+}
+
+Bool NetMessageFrame::consume()
+{
+    return m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
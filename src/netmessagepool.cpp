@@ -0,0 +1,228 @@
+/**
+ * @file netmessagepool.cpp
+ * @brief Per message code free lists of incoming messages.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/netmessagepool.h"
+#include "o3d/net/netmessageadapter.h"
+#include <o3d/core/debug.h>
+
+using namespace o3d;
+using namespace o3d::net;
+
+namespace {
+
+//! Per thread cache of messages, owned by a single pool at a time.
+struct ThreadMessageCache
+{
+    UInt32 poolId;
+    UInt32 count;   //!< total number of cached messages
+    std::vector<std::vector<AbstractNetMessageIn*>> slots;
+
+    ~ThreadMessageCache()
+    {
+        // the pool may be gone, messages are deleted
+        for (std::vector<AbstractNetMessageIn*> &slot : slots)
+        {
+            for (AbstractNetMessageIn *message : slot)
+            {
+                delete message;
+            }
+        }
+    }
+};
+
+thread_local ThreadMessageCache t_messageCache;
+
+std::atomic<UInt32> ms_nextPoolId(1);
+
+} // anonymous namespace
+
+NetMessagePool::NetMessagePool(UInt32 maxFree) :
+    m_id(ms_nextPoolId++),
+    m_maxFree(maxFree),
+    m_numAcquires(0),
+    m_numAllocations(0)
+{
+}
+
+NetMessagePool::~NetMessagePool()
+{
+    for (FreeList &freeList : m_free)
+    {
+        for (AbstractNetMessageIn *message : freeList)
+        {
+            delete message;
+        }
+    }
+
+    // and the cache of the destroying thread
+    ThreadMessageCache &cache = t_messageCache;
+    if (cache.poolId == m_id)
+    {
+        for (std::vector<AbstractNetMessageIn*> &slot : cache.slots)
+        {
+            for (AbstractNetMessageIn *message : slot)
+            {
+                delete message;
+            }
+
+            slot.clear();
+        }
+
+        cache.count = 0;
+        cache.poolId = 0;
+    }
+}
+
+void NetMessagePool::registerPrototype(AbstractNetMessageIn *prototype)
+{
+    O3D_CHECKPTR(prototype);
+
+    FastMutexLocker locker(m_mutex);
+
+    prototype->m_poolSlot = (UInt32)m_free.size();
+    m_free.push_back(FreeList());
+}
+
+AbstractNetMessageIn* NetMessagePool::acquire(const AbstractNetMessageIn *prototype)
+{
+    const UInt32 slot = prototype->m_poolSlot;
+
+    // not registered
+    if (slot == 0xffffffff)
+        return prototype->makeInstance();
+
+    ++m_numAcquires;
+
+    AbstractNetMessageIn *message = nullptr;
+
+    // thread cache, without lock
+    ThreadMessageCache &cache = t_messageCache;
+    if ((cache.poolId == m_id) && (slot < cache.slots.size()) && !cache.slots[slot].empty())
+    {
+        message = cache.slots[slot].back();
+        cache.slots[slot].pop_back();
+        --cache.count;
+    }
+    else
+    {
+        m_mutex.lock();
+
+        FreeList &freeList = m_free[slot];
+        if (!freeList.empty())
+        {
+            message = freeList.back();
+            freeList.pop_back();
+        }
+
+        m_mutex.unlock();
+    }
+
+    if (message)
+    {
+        message->recycle();
+        return message;
+    }
+
+    ++m_numAllocations;
+
+    message = prototype->makeInstance();
+    message->m_pool = this;
+    message->m_poolSlot = slot;
+
+    return message;
+}
+
+void NetMessagePool::release(AbstractNetMessageIn *message)
+{
+    const UInt32 slot = message->m_poolSlot;
+
+    // the cache is taken by the pool when empty
+    ThreadMessageCache &cache = t_messageCache;
+    if (cache.count == 0)
+        cache.poolId = m_id;
+
+    if (cache.poolId == m_id)
+    {
+        if (slot >= cache.slots.size())
+            cache.slots.resize(slot + 1);
+
+        std::vector<AbstractNetMessageIn*> &cached = cache.slots[slot];
+        if (cached.size() < THREAD_CACHE_SIZE)
+        {
+            cached.push_back(message);
+            ++cache.count;
+            return;
+        }
+
+        // full, move half of the cache and the message to the shared list
+        const UInt32 half = THREAD_CACHE_SIZE / 2;
+        AbstractNetMessageIn *overflow[THREAD_CACHE_SIZE / 2 + 1];
+
+        for (UInt32 i = 0; i < half; ++i)
+        {
+            overflow[i] = cached.back();
+            cached.pop_back();
+        }
+
+        overflow[half] = message;
+        cache.count -= half;
+
+        UInt32 n = 0;
+
+        m_mutex.lock();
+
+        FreeList &freeList = m_free[slot];
+        for (; (n <= half) && (freeList.size() < m_maxFree); ++n)
+        {
+            freeList.push_back(overflow[n]);
+        }
+
+        m_mutex.unlock();
+
+        for (; n <= half; ++n)
+        {
+            delete overflow[n];
+        }
+
+        return;
+    }
+
+    m_mutex.lock();
+
+    FreeList &freeList = m_free[slot];
+    if (freeList.size() < m_maxFree)
+    {
+        freeList.push_back(message);
+        message = nullptr;
+    }
+
+    m_mutex.unlock();
+
+    if (message)
+        delete message;
+}
+
+NetMessagePool::Stats NetMessagePool::getStats() const
+{
+    Stats stats;
+
+    stats.numAcquires = m_numAcquires;
+    stats.numAllocations = m_numAllocations;
+    stats.numFree = 0;
+
+    FastMutexLocker locker(m_mutex);
+    for (const FreeList &freeList : m_free)
+    {
+        stats.numFree += (UInt32)freeList.size();
+    }
+
+    return stats;
+}
@@ -17,3 +17,25 @@ NetReadWriteAdapter::~NetReadWriteAdapter()
 {
 }
 
+
+void NetReadWriteAdapter::beginWrite(NetBuffer *buffer)
+{
+}
+
+void NetReadWriteAdapter::endWrite(NetBuffer *buffer)
+{
+}
+
+Bool NetReadWriteAdapter::readHeader(NetBuffer *buffer)
+{
+    return True;
+}
+
+Bool NetReadWriteAdapter::isShareable() const
+{
+    return True;
+}
+
+NetReadWriteAdapterFactory::~NetReadWriteAdapterFactory()
+{
+}
@@ -8,7 +8,7 @@
  */
 
 #include "o3d/net/netsession.h"
-#include "o3d/net/netbuffer.h"
+#include "o3d/net/segmentednetbuffer.h"
 #include <o3d/core/debug.h>
 
 using namespace o3d;
@@ -24,13 +24,15 @@ NetSession::NetSession(Socket *socket,
     m_shutdownCause(SHUTDOWN_CAUSE_UNKNOW),
     m_readPendingMessage(nullptr),
     m_writePendingMessage(nullptr),
+    m_readStringTable(nullptr),
+    m_writeStringTable(nullptr),
     m_nextState(1),
     m_currentState(0)
 {
     O3D_CHECKPTR(messageFactory);
 
-    m_readBuffer = new ArrayNetBuffer(2048);
-    m_writeBuffer = new ArrayNetBuffer(2048);
+    m_readBuffer = new SegmentedNetBuffer();
+    m_writeBuffer = new SegmentedNetBuffer();
 
     m_messageFactory = messageFactory;
     m_outgoingList = new PCQueue<NetMessage*> ();
@@ -46,25 +48,32 @@ NetSession::~NetSession()
     deletePtr(m_readBuffer);
     deletePtr(m_writeBuffer);
 
+    deletePtr(m_readStringTable);
+    deletePtr(m_writeStringTable);
+
     NetMessage* message;
     while ((message = popIncomingMessage()) != nullptr)
     {
-        deletePtr(message);
+        message->release();
     }
 
+    // a shared message is released by its last session
     while ((message = popOutgoingMessage()) != nullptr)
     {
-        deletePtr(message);
+        if (message->consume())
+            message->release();
     }
 
     if (m_writePendingMessage != nullptr)
     {
-        deletePtr(m_writePendingMessage);
+        if (m_writePendingMessage->consume())
+            m_writePendingMessage->release();
     }
 
     if (m_readPendingMessage != nullptr)
     {
-        deletePtr(m_readPendingMessage);
+        m_readPendingMessage->release();
+        m_readPendingMessage = nullptr;
     }
 
     deletePtr(m_outgoingList);
@@ -192,6 +201,33 @@ void NetSession::deleteReadWriteAdapter()
     deletePtr(m_readWriteAdapter);
 }
 
+void NetSession::setBuffers(NetBuffer *readBuffer, NetBuffer *writeBuffer)
+{
+    O3D_CHECKPTR(readBuffer);
+    O3D_CHECKPTR(writeBuffer);
+
+    deletePtr(m_readBuffer);
+    deletePtr(m_writeBuffer);
+
+    m_readBuffer = readBuffer;
+    m_writeBuffer = writeBuffer;
+
+    m_readBuffer->setStringTable(m_readStringTable);
+    m_writeBuffer->setStringTable(m_writeStringTable);
+}
+
+void NetSession::enableStringInterning(UInt32 capacity, UInt32 maxLength)
+{
+    deletePtr(m_readStringTable);
+    deletePtr(m_writeStringTable);
+
+    m_readStringTable = new NetStringTable(capacity, maxLength);
+    m_writeStringTable = new NetStringTable(capacity, maxLength);
+
+    m_readBuffer->setStringTable(m_readStringTable);
+    m_writeBuffer->setStringTable(m_writeStringTable);
+}
+
 void NetSession::pushIncomingMessage(NetMessage* message)
 {
     O3D_CHECKPTR(message);
@@ -256,29 +292,38 @@ void NetSession::handleRead()
 
         while ((m_readPendingMessage == nullptr) && (m_readBuffer->getAvailable() > 0))
         {
+            // framing of the adapter, that can be incomplete too
+            if ((m_readWriteAdapter != nullptr) && !m_readWriteAdapter->readHeader(m_readBuffer))
+                break;
+
+            // the message code can be incomplete, then wait for more data
+            m_readBuffer->mark();
+
             NetMessage* message = m_messageFactory->buildFromBuffer(m_readBuffer);
-            if (message != nullptr)
+            if (message == nullptr)
             {
-                if (m_readWriteAdapter != nullptr)
-                {
-                    m_readPendingMessage = m_readWriteAdapter->readFrom(
-                            m_readBuffer,
-                            message);
-                }
-                else
-                    m_readPendingMessage = message->readFromBuffer(m_readBuffer);
+                m_readBuffer->rollback();
+                break;
+            }
 
-                if (m_readPendingMessage == nullptr)
-                {
-                    // Message is ready to be processed
-                    pushIncomingMessage(message);
-                }
+            m_readBuffer->commit();
+
+            if (m_readWriteAdapter != nullptr)
+            {
+                m_readPendingMessage = m_readWriteAdapter->readFrom(
+                        m_readBuffer,
+                        message);
+            }
+            else
+                m_readPendingMessage = message->readFromBuffer(m_readBuffer);
+
+            if (m_readPendingMessage == nullptr)
+            {
+                // Message is ready to be processed
+                pushIncomingMessage(message);
             }
         }
-        if ((m_readPendingMessage == nullptr) && (m_readBuffer->getAvailable() > 0))
-        {
-            O3D_WARNING("There is no pending read message and there is still data on read buffer");
-        }
+        // an incomplete message header stays in the buffer until more data are received
         m_readBuffer->compact();
     }
 }
@@ -287,9 +332,12 @@ void NetSession::handleWrite()
 {
     NetMessage* message;
 
+    if (m_readWriteAdapter != nullptr)
+        m_readWriteAdapter->beginWrite(m_writeBuffer);
+
     while ((message = popOutgoingMessage(), message != nullptr) && (m_writeBuffer->getFree() > 2))
     {
-        if (m_readWriteAdapter != nullptr)
+        if ((m_readWriteAdapter != nullptr) && !message->isFramed())
         {
             m_readWriteAdapter->writeTo(m_writeBuffer, message);
         }
@@ -297,9 +345,12 @@ void NetSession::handleWrite()
             message->writeToBuffer(m_writeBuffer);
 
         if (message->consume())
-            deletePtr(message);
+            message->release();
     }
 
+    if (m_readWriteAdapter != nullptr)
+        m_readWriteAdapter->endWrite(m_writeBuffer);
+
     if (m_writeBuffer->getAvailable() > 0)
     {
         m_socket->sendFromBuffer(m_writeBuffer, 0);
@@ -0,0 +1,270 @@
+/**
+ * @file netstringtable.cpp
+ * @brief Per-connection bounded table of interned strings.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/netstringtable.h"
+#include <o3d/core/debug.h>
+
+using namespace o3d;
+using namespace o3d::net;
+
+NetStringTable::NetStringTable(UInt32 capacity, UInt32 maxLength) :
+    m_capacity(capacity),
+    m_maxLength(maxLength),
+    m_bucketMask(0),
+    m_numEntries(0),
+    m_newest(NO_SLOT),
+    m_oldest(NO_SLOT),
+    m_marked(False)
+{
+    if ((capacity == 0) || (capacity > MAX_CAPACITY))
+    {
+        O3D_ERROR(E_InvalidParameter("String table capacity must be in [1..65536]"));
+    }
+
+    m_stats.numHits = 0;
+    m_stats.numMisses = 0;
+    m_stats.numLiterals = 0;
+}
+
+NetStringTable::~NetStringTable()
+{
+}
+
+void NetStringTable::clear()
+{
+    m_entries.clear();
+    m_buckets.clear();
+    m_bucketMask = 0;
+    m_numEntries = 0;
+    m_newest = NO_SLOT;
+    m_oldest = NO_SLOT;
+
+    m_marked = False;
+    m_pending.clear();
+
+    m_strings.clear();
+    m_defined.clear();
+}
+
+UInt32 NetStringTable::intern(const Char *data, UInt32 length, Bool &defined)
+{
+    defined = False;
+
+    if (length > m_maxLength)
+    {
+        ++m_stats.numLiterals;
+        return NO_SLOT;
+    }
+
+    if (m_buckets.empty())
+    {
+        // power of two at least twice the capacity, for short chains
+        UInt32 numBuckets = 16;
+        while (numBuckets < m_capacity * 2)
+        {
+            numBuckets <<= 1;
+        }
+
+        m_buckets.assign(numBuckets, static_cast<UInt32>(NO_SLOT));
+        m_bucketMask = numBuckets - 1;
+        m_entries.resize(m_capacity);
+    }
+
+    const UInt32 h = hash(data, length);
+
+    for (UInt32 slot = m_buckets[h & m_bucketMask]; slot != NO_SLOT; slot = m_entries[slot].next)
+    {
+        const Entry &entry = m_entries[slot];
+        if ((entry.hash == h) && (entry.data.size() == length) &&
+            (memcmp(entry.data.data(), data, length) == 0))
+        {
+            if (slot != m_newest)
+            {
+                unlink(slot);
+                pushNewest(slot);
+            }
+
+            ++m_stats.numHits;
+            return slot;
+        }
+    }
+
+    // new string, take a free slot or reuse the least recently used one
+    UInt32 slot;
+    if (m_numEntries < m_capacity)
+    {
+        slot = m_numEntries++;
+    }
+    else
+    {
+        slot = m_oldest;
+
+        if (m_entries[slot].valid)
+            removeFromBucket(slot);
+
+        unlink(slot);
+    }
+
+    Entry &entry = m_entries[slot];
+    entry.data.assign(data, length);
+    entry.valid = True;
+    entry.hash = h;
+    entry.next = m_buckets[h & m_bucketMask];
+    m_buckets[h & m_bucketMask] = slot;
+
+    pushNewest(slot);
+
+    ++m_stats.numMisses;
+    defined = True;
+
+    if (m_marked)
+        m_pending.push_back(slot);
+
+    return slot;
+}
+
+void NetStringTable::mark()
+{
+    m_marked = True;
+    m_pending.clear();
+}
+
+void NetStringTable::commit()
+{
+    m_marked = False;
+    m_pending.clear();
+}
+
+void NetStringTable::rollback()
+{
+    // the peer never received these definitions, the slots are made free again, and
+    // reused first, so a reference is never sent without a definition
+    for (UInt32 slot : m_pending)
+    {
+        Entry &entry = m_entries[slot];
+        if (!entry.valid)
+            continue;
+
+        removeFromBucket(slot);
+
+        entry.data.clear();
+        entry.valid = False;
+
+        unlink(slot);
+        pushOldest(slot);
+    }
+
+    m_marked = False;
+    m_pending.clear();
+}
+
+const String& NetStringTable::define(UInt32 id, const Char *data, UInt32 length)
+{
+    if (id >= m_capacity)
+    {
+        O3D_ERROR(E_InvalidParameter("String table slot out of capacity"));
+    }
+
+    if (m_strings.empty())
+    {
+        m_strings.resize(m_capacity);
+        m_defined.assign(m_capacity, False);
+    }
+
+    String &string = m_strings[id];
+    string = String();
+
+    if (length > 0)
+        string.fromUtf8(data, length);
+
+    m_defined[id] = True;
+    ++m_stats.numMisses;
+
+    return string;
+}
+
+const String* NetStringTable::lookup(UInt32 id)
+{
+    if ((id >= m_strings.size()) || !m_defined[id])
+        return nullptr;
+
+    ++m_stats.numHits;
+    return &m_strings[id];
+}
+
+UInt32 NetStringTable::hash(const Char *data, UInt32 length)
+{
+    // FNV-1a
+    UInt32 h = 2166136261u;
+    for (UInt32 i = 0; i < length; ++i)
+    {
+        h ^= static_cast<UInt8>(data[i]);
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+void NetStringTable::unlink(UInt32 slot)
+{
+    Entry &entry = m_entries[slot];
+
+    if (entry.prev != NO_SLOT)
+        m_entries[entry.prev].older = entry.older;
+    else
+        m_newest = entry.older;
+
+    if (entry.older != NO_SLOT)
+        m_entries[entry.older].prev = entry.prev;
+    else
+        m_oldest = entry.prev;
+}
+
+void NetStringTable::pushNewest(UInt32 slot)
+{
+    Entry &entry = m_entries[slot];
+
+    entry.prev = NO_SLOT;
+    entry.older = m_newest;
+
+    if (m_newest != NO_SLOT)
+        m_entries[m_newest].prev = slot;
+    else
+        m_oldest = slot;
+
+    m_newest = slot;
+}
+
+void NetStringTable::pushOldest(UInt32 slot)
+{
+    Entry &entry = m_entries[slot];
+
+    entry.prev = m_oldest;
+    entry.older = NO_SLOT;
+
+    if (m_oldest != NO_SLOT)
+        m_entries[m_oldest].older = slot;
+    else
+        m_newest = slot;
+
+    m_oldest = slot;
+}
+
+void NetStringTable::removeFromBucket(UInt32 slot)
+{
+    UInt32 *link = &m_buckets[m_entries[slot].hash & m_bucketMask];
+    while (*link != slot)
+    {
+        link = &m_entries[*link].next;
+    }
+
+    *link = m_entries[slot].next;
+}
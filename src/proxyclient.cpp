@@ -74,7 +74,7 @@ Int32 ProxyClient::run(void *)
 
             // delete if zero is reached
             if (message->consume())
-                deletePtr(message);
+                message->release();
 
         } catch(E_RunMessage &e)
         {
@@ -9,6 +9,7 @@
 
 #include "o3d/net/proxymessages.h"
 #include "o3d/net/netbuffer.h"
+#include "o3d/net/netcodec.h"
 
 #include "o3d/net/proxyclient.h"
 #include "o3d/net/proxyserver.h"
@@ -20,18 +21,22 @@ using namespace o3d::net;
 
 NetMessage *ProxyChallengeOut::writeToBuffer(NetBuffer *buffer)
 {
-    buffer->writeInt32(m_version);
-    buffer->write(m_challenge, 16);
+    NetCodec::encode(buffer, 20, [this] (auto &out) {
+        out.writeInt32(m_version);
+        out.write(m_challenge, 16);
+    });
 
     return nullptr;
 }
 
 NetMessage* ProxyChallengeIn::readFromBuffer(NetBuffer* buffer)
 {
-    m_version = buffer->readInt32();
-    buffer->read(m_challenge, 16);
+    Bool done = NetCodec::decode(buffer, 20, [this] (auto &in) {
+        m_version = in.readInt32();
+        in.read(m_challenge, 16);
+    });
 
-    return nullptr;
+    return done ? nullptr : this;
 }
 
 void ProxyChallengeIn::run(void *context)
@@ -95,3 +100,9 @@ void ProxyCertificateIn::run(void *context)
     O3D_MESSAGE("Validate proxy session");
 }
 
+void ProxyRawMessageIn::run(void *context)
+{
+    // run on proxy server side
+    ProxyServerSession *session = (ProxyServerSession*)context;
+    session->forward(this);
+}
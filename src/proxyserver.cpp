@@ -11,11 +11,21 @@
 #include <o3d/core/architecture.h>
 #include "o3d/net/proxyserver.h"
 #include "o3d/net/proxymessages.h"
+#include "o3d/net/netmessageframe.h"
+#include "o3d/net/rawnetmessagein.h"
+#include "o3d/net/segmentednetbuffer.h"
 #include <o3d/core/debug.h>
 
 using namespace o3d;
 using namespace o3d::net;
 
+//
+// ProxyRouter
+//
+ProxyRouter::~ProxyRouter()
+{
+}
+
 //
 // ProxyServer
 //
@@ -32,11 +42,17 @@ ProxyServer::ProxyServer(
     m_timeUnit(timeUnit),
     m_netMessageFactory(factory),
     m_readWriteAdapter(adapter),
+    m_readWriteAdapterFactory(nullptr),
+    m_router(nullptr),
     m_server(nullptr),
     m_acceptor(nullptr),
     m_executor(nullptr)
 {
     O3D_ASSERT(m_netMessageFactory);
+
+    // the sessions run concurrently, a per connection state would be mixed up
+    if ((m_readWriteAdapter != nullptr) && !m_readWriteAdapter->isShareable())
+        O3D_ERROR(E_InvalidParameter("Adapter not shareable, use an adapter factory"));
 }
 
 ProxyServer::~ProxyServer()
@@ -86,12 +102,83 @@ void ProxyServer::multicast(NetMessage *msg)
 {
     FastMutexLocker locker(m_mutex);
 
+    if (m_sessions.empty())
+    {
+        msg->release();
+        return;
+    }
+
+    if (m_readWriteAdapterFactory != nullptr)
+    {
+        // the framing depends on the state of each adapter, only the payload is shared
+        AbstractNetMessage *m = reinterpret_cast<AbstractNetMessage*>(msg);
+        SegmentedNetBuffer buffer;
+
+        if (msg->writeToBuffer(&buffer) != nullptr)
+            O3D_ERROR(E_BufferOverflow("Message too large for a multicast"));
+
+        RawNetMessageIn *raw = new RawNetMessageIn;
+        raw->setMessageCode(m->getMessageCode());
+        raw->setMessageSize(buffer.getAvailable());
+        raw->readFromBuffer(&buffer);
+
+        msg->release();
+
+        // consumed by each session after its write
+        for (size_t i = 1; i < m_sessions.size(); ++i)
+        {
+            raw->retain();
+        }
+
+        for (std::pair<Int32, ProxyServerSession*> entry : m_sessions)
+        {
+            entry.second->send(raw);
+        }
+
+        return;
+    }
+
+    // serialized once, with the same framing than the sessions
+    NetMessageFrame *frame = nullptr;
+
+    if (m_readWriteAdapter != nullptr)
+    {
+        frame = new NetMessageFrame(msg, m_readWriteAdapter, (UInt32)m_sessions.size());
+    }
+    else
+    {
+        DefaultNetMessageAdapter adapter;
+        frame = new NetMessageFrame(msg, &adapter, (UInt32)m_sessions.size());
+    }
+
+    msg->release();
+
     for (std::pair<Int32, ProxyServerSession*> entry : m_sessions)
     {
-        entry.second->send(msg);
+        entry.second->send(frame);
     }
 }
 
+void ProxyServer::forward(Int32 sessionId, RawNetMessageIn *msg)
+{
+    if (m_router == nullptr)
+        return;
+
+    const Int32 target = m_router->route(sessionId, msg->getMessageCode(), msg->getMessageSize());
+    if (target < 0)
+        return;
+
+    FastMutexLocker locker(m_mutex);
+
+    auto it = m_sessions.find(target);
+    if (it == m_sessions.end())
+        return;
+
+    // consumed by the source session after its run, and by the target after its write
+    msg->retain();
+    it->second->send(msg);
+}
+
 o3d::UInt32 ProxyServer::getNumSessions() const
 {
     FastMutexLocker locker(m_mutex);
@@ -195,12 +282,18 @@ ProxyServerSession::ProxyServerSession(ProxyServer *proxyServer, Socket *client)
     m_proxyServer(proxyServer),
     m_id(-1),
     m_netSession(nullptr),
+    m_deltaState(nullptr),
     m_cancel(False),
     m_valid(False)
 {
     O3D_ASSERT(m_proxyServer != nullptr);
 
-    if (m_proxyServer->getReadWriteAdapter() == nullptr)
+    if (m_proxyServer->getReadWriteAdapterFactory() != nullptr)
+        m_netSession = new NetSession(
+                    client,
+                    m_proxyServer->getNetMessageFactory(),
+                    m_proxyServer->getReadWriteAdapterFactory()->createReadWriteAdapter());
+    else if (m_proxyServer->getReadWriteAdapter() == nullptr)
         m_netSession = new NetSession(
                     client,
                     m_proxyServer->getNetMessageFactory(),
@@ -226,7 +319,19 @@ ProxyServerSession::ProxyServerSession(ProxyServer *proxyServer, Socket *client)
 
 ProxyServerSession::~ProxyServerSession()
 {
+    // the adapter of the session, unless the shared one
+    if (m_netSession->getReadWriteAdapter() != m_proxyServer->getReadWriteAdapter())
+        m_netSession->deleteReadWriteAdapter();
+
+    // the pending snapshots refer to the delta state
     deletePtr(m_netSession);
+    deletePtr(m_deltaState);
+}
+
+void ProxyServerSession::setDeltaState(NetDeltaState *state)
+{
+    deletePtr(m_deltaState);
+    m_deltaState = state;
 }
 
 Int32 ProxyServerSession::run(void *context)
@@ -259,7 +364,7 @@ Int32 ProxyServerSession::run(void *context)
 
             // delete if zero is reached
             if (message->consume())
-                deletePtr(message);
+                message->release();
 
         } catch(E_RunMessage &e)
         {
@@ -273,6 +378,14 @@ Int32 ProxyServerSession::run(void *context)
     return 0;
 }
 
+void ProxyServerSession::forward(RawNetMessageIn *message)
+{
+    if (!m_valid || m_cancel)
+        return;
+
+    m_proxyServer->forward(m_id, message);
+}
+
 void ProxyServerSession::cancel()
 {
     // TODO what about not runned message, and no sent messages,
@@ -0,0 +1,92 @@
+/**
+ * @file rawnetmessagein.cpp
+ * @brief Incoming message kept as its raw payload, for passthrough forwarding.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+#include <o3d/core/architecture.h>
+
+#include "o3d/net/rawnetmessagein.h"
+#include "o3d/net/netbuffer.h"
+#include <o3d/core/debug.h>
+
+using namespace o3d;
+using namespace o3d::net;
+
+RawNetMessageIn::RawNetMessageIn() :
+    m_code(0),
+    m_received(0),
+    m_refs(1)
+{
+}
+
+RawNetMessageIn::~RawNetMessageIn()
+{
+}
+
+UInt32 RawNetMessageIn::getMessageCode() const
+{
+    return m_code;
+}
+
+AbstractNetMessageIn *RawNetMessageIn::makeInstance() const
+{
+    return new RawNetMessageIn;
+}
+
+void RawNetMessageIn::setMessageSize(UInt32 dataSize)
+{
+    m_messageDataSize = dataSize;
+    m_received = 0;
+
+    m_data.resize(dataSize);
+}
+
+NetMessage* RawNetMessageIn::readFromBuffer(NetBuffer* buffer)
+{
+    // straight copy of the readable spans
+    while (m_received < m_messageDataSize)
+    {
+        UInt32 size = 0;
+        const UInt8 *span = buffer->getReadableSpan(size);
+
+        if (size == 0)
+            return this;
+
+        if (size > m_messageDataSize - m_received)
+            size = m_messageDataSize - m_received;
+
+        memcpy(m_data.data() + m_received, span, size);
+        buffer->skip(size);
+
+        m_received += size;
+    }
+
+    return nullptr;
+}
+
+NetMessage* RawNetMessageIn::writeToBuffer(NetBuffer* buffer)
+{
+    if (m_messageDataSize > 0)
+        buffer->write(m_data.data(), m_messageDataSize);
+
+    return nullptr;
+}
+
+Bool RawNetMessageIn::consume()
+{
+    return m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
+void RawNetMessageIn::recycle()
+{
+    AbstractNetMessageIn::recycle();
+
+    m_code = 0;
+    m_received = 0;
+    m_refs.store(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,561 @@
+/**
+ * @file ringnetbuffer.cpp
+ * @brief Circular buffer that never moves its data.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/ringnetbuffer.h"
+#include <o3d/core/debug.h>
+
+#include <algorithm>
+#include <vector>
+
+#ifndef O3D_WINDOWS
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <stdlib.h>
+#endif
+
+using namespace o3d;
+using namespace o3d::net;
+
+RingNetBuffer::RingNetBuffer(UInt32 size, Bool mirror) :
+    m_mirrored(False),
+    m_size(1),
+    m_array(nullptr),
+    m_readPosition(0),
+    m_writePosition(0)
+{
+    if ((size == 0) || (size > 0x40000000))
+        O3D_ERROR(E_InvalidParameter("Ring size must be in ]0..1GB]"));
+
+    while (m_size < size)
+    {
+        m_size <<= 1;
+    }
+
+    if (!mirror || !mapMirror())
+        m_array = new UInt8[m_size];
+
+    setByteOrder(System::getNativeByteOrder());
+}
+
+RingNetBuffer::~RingNetBuffer()
+{
+    if (m_mirrored)
+        unmapMirror();
+    else
+        deleteArray(m_array);
+}
+
+#ifndef O3D_WINDOWS
+Bool RingNetBuffer::mapMirror()
+{
+    const UInt32 pageSize = (UInt32)sysconf(_SC_PAGESIZE);
+    UInt32 size = std::max(m_size, pageSize);
+
+    int fd = -1;
+#ifdef SYS_memfd_create
+    fd = (int)syscall(SYS_memfd_create, "o3dnet-ring", 0);
+#endif
+    if (fd < 0)
+    {
+        char path[] = "/tmp/o3dnet-ringXXXXXX";
+        fd = mkstemp(path);
+        if (fd < 0)
+            return False;
+
+        unlink(path);
+    }
+
+    if (ftruncate(fd, size) != 0)
+    {
+        ::close(fd);
+        return False;
+    }
+
+    // reserve twice the size, and then map the same file on each half
+    UInt8 *addr = (UInt8*)mmap(nullptr, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        ::close(fd);
+        return False;
+    }
+
+    if ((mmap(addr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) ||
+        (mmap(addr + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED))
+    {
+        munmap(addr, size * 2);
+        ::close(fd);
+        return False;
+    }
+
+    // mappings keep the file alive
+    ::close(fd);
+
+    m_array = addr;
+    m_size = size;
+    m_mirrored = True;
+
+    return True;
+}
+
+void RingNetBuffer::unmapMirror()
+{
+    munmap(m_array, m_size * 2);
+    m_array = nullptr;
+    m_mirrored = False;
+}
+#else
+Bool RingNetBuffer::mapMirror()
+{
+    // not supported, use a single mapping
+    return False;
+}
+
+void RingNetBuffer::unmapMirror()
+{
+}
+#endif // O3D_WINDOWS
+
+void RingNetBuffer::writeBytes(const UInt8 *data, UInt32 size)
+{
+    if (size > m_size - (m_writePosition - m_readPosition))
+        O3D_ERROR(E_BufferOverflow("Write overflow"));
+
+    const UInt32 offset = m_writePosition & (m_size - 1);
+
+    if (m_mirrored || (offset + size <= m_size))
+    {
+        memcpy(m_array + offset, data, size);
+    }
+    else
+    {
+        const UInt32 len = m_size - offset;
+        memcpy(m_array + offset, data, len);
+        memcpy(m_array, data + len, size - len);
+    }
+
+    m_writePosition += size;
+}
+
+void RingNetBuffer::readBytes(UInt8 *data, UInt32 size)
+{
+    if (size > m_writePosition - m_readPosition)
+        O3D_ERROR(E_BufferOverflow("Read overflow"));
+
+    const UInt32 offset = m_readPosition & (m_size - 1);
+
+    if (m_mirrored || (offset + size <= m_size))
+    {
+        memcpy(data, m_array + offset, size);
+    }
+    else
+    {
+        const UInt32 len = m_size - offset;
+        memcpy(data, m_array + offset, len);
+        memcpy(data + len, m_array, size - len);
+    }
+
+    m_readPosition += size;
+}
+
+void RingNetBuffer::writeSwapped(const UInt8 *value, UInt32 size)
+{
+    if (m_swap)
+    {
+        UInt8 swapped[8];
+        for (UInt32 i = 0; i < size; ++i)
+        {
+            swapped[i] = value[size - 1 - i];
+        }
+
+        writeBytes(swapped, size);
+    }
+    else
+        writeBytes(value, size);
+}
+
+void RingNetBuffer::readSwapped(UInt8 *value, UInt32 size)
+{
+    if (m_swap)
+    {
+        UInt8 swapped[8];
+        readBytes(swapped, size);
+
+        for (UInt32 i = 0; i < size; ++i)
+        {
+            value[i] = swapped[size - 1 - i];
+        }
+    }
+    else
+        readBytes(value, size);
+}
+
+void RingNetBuffer::writeInt8(Int8 value)
+{
+    writeBytes(reinterpret_cast<const UInt8*>(&value), 1);
+}
+
+void RingNetBuffer::writeUInt8(UInt8 value)
+{
+    writeBytes(&value, 1);
+}
+
+void RingNetBuffer::writeInt16(Int16 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 2);
+}
+
+void RingNetBuffer::writeUInt16(UInt16 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 2);
+}
+
+void RingNetBuffer::writeInt32(Int32 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 4);
+}
+
+void RingNetBuffer::writeUInt32(UInt32 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 4);
+}
+
+void RingNetBuffer::writeInt64(Int64 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 8);
+}
+
+void RingNetBuffer::writeUInt64(UInt64 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 8);
+}
+
+void RingNetBuffer::writeUTF8(const String &string)
+{
+    CString utf8 = string.toUtf8();
+
+    writeInt16((Int16)utf8.length());
+    writeBytes(reinterpret_cast<const UInt8*>(utf8.getData()), utf8.length());
+}
+
+void RingNetBuffer::writeUTF8(const Char *string)
+{
+    UInt32 length = (UInt32)strlen(string);
+
+    writeInt16((Int16)length);
+    writeBytes(reinterpret_cast<const UInt8*>(string), length);
+}
+
+void RingNetBuffer::writeBool(Bool value)
+{
+    writeUInt8(value ? 1 : 0);
+}
+
+void RingNetBuffer::write(const UInt8 *buffer, UInt32 size)
+{
+    writeBytes(buffer, size);
+}
+
+Int8 RingNetBuffer::readInt8()
+{
+    Int8 value;
+    readBytes(reinterpret_cast<UInt8*>(&value), 1);
+    return value;
+}
+
+UInt8 RingNetBuffer::readUInt8()
+{
+    UInt8 value;
+    readBytes(&value, 1);
+    return value;
+}
+
+Int16 RingNetBuffer::readInt16()
+{
+    Int16 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 2);
+    return value;
+}
+
+UInt16 RingNetBuffer::readUInt16()
+{
+    UInt16 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 2);
+    return value;
+}
+
+Int32 RingNetBuffer::readInt32()
+{
+    Int32 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 4);
+    return value;
+}
+
+UInt32 RingNetBuffer::readUInt32()
+{
+    UInt32 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 4);
+    return value;
+}
+
+Int64 RingNetBuffer::readInt64()
+{
+    Int64 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 8);
+    return value;
+}
+
+UInt64 RingNetBuffer::readUInt64()
+{
+    UInt64 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 8);
+    return value;
+}
+
+Bool RingNetBuffer::read(UInt8 *buffer, Int16 size)
+{
+    if ((size >= 0) && (getAvailable() >= size))
+    {
+        readBytes(buffer, size);
+        return True;
+    }
+    return False;
+}
+
+Bool RingNetBuffer::readUTF8(Char *string, Int16 size)
+{
+    if ((size >= 0) && (getAvailable() >= size))
+    {
+        readBytes(reinterpret_cast<UInt8*>(string), size);
+        string[size] = 0x00;
+        return True;
+    }
+    return False;
+}
+
+Bool RingNetBuffer::readUTF8(String &string)
+{
+    if (getAvailable() >= 2)
+    {
+        Int16 size = readInt16();
+        if ((getAvailable() >= size) && (size > 0))
+        {
+            const UInt32 offset = m_readPosition & (m_size - 1);
+
+            if (m_mirrored || (offset + size <= m_size))
+            {
+                string.fromUtf8(reinterpret_cast<Char*>(m_array + offset), size);
+                m_readPosition += size;
+            }
+            else
+            {
+                std::vector<Char> utf8(size);
+                readBytes(reinterpret_cast<UInt8*>(utf8.data()), size);
+                string.fromUtf8(utf8.data(), size);
+            }
+        }
+        else
+        {
+            string << "";
+        }
+        return True;
+    }
+    return False;
+}
+
+Bool RingNetBuffer::readBool()
+{
+    return readUInt8() != 0 ? True : False;
+}
+
+Int32 RingNetBuffer::getAvailable() const
+{
+    return m_writePosition - m_readPosition;
+}
+
+Int32 RingNetBuffer::getFree() const
+{
+    return m_size - (m_writePosition - m_readPosition);
+}
+
+void RingNetBuffer::patch(UInt32 handle, const UInt8 *data, UInt32 size)
+{
+    // the bytes must be written and not yet overwritten
+    if ((m_writePosition - handle > m_size) || (size > m_writePosition - handle))
+        O3D_ERROR(E_BufferOverflow("Patch overflow"));
+
+    const UInt32 offset = handle & (m_size - 1);
+
+    if (m_mirrored || (offset + size <= m_size))
+    {
+        memcpy(m_array + offset, data, size);
+    }
+    else
+    {
+        const UInt32 len = m_size - offset;
+        memcpy(m_array + offset, data, len);
+        memcpy(m_array, data + len, size - len);
+    }
+}
+
+UInt32 RingNetBuffer::getLimit() const
+{
+    return m_writePosition;
+}
+
+void RingNetBuffer::setLimit(UInt32 limit)
+{
+    if ((limit < m_readPosition) || (limit - m_readPosition > m_size))
+    {
+        O3D_ERROR(E_BufferOverflow("Limit overflow"));
+    }
+    else
+    {
+        m_writePosition = limit;
+    }
+}
+
+UInt32 RingNetBuffer::getPosition() const
+{
+    return m_readPosition;
+}
+
+void RingNetBuffer::setPosition(UInt32 position)
+{
+    if ((position > m_writePosition) || (m_writePosition - position > m_size))
+    {
+        O3D_ERROR(E_BufferOverflow("Position overflow"));
+    }
+    else
+    {
+        m_readPosition = position;
+    }
+}
+
+UInt8* RingNetBuffer::getWriteBuffer()
+{
+    return at(m_writePosition);
+}
+
+UInt8* RingNetBuffer::getBuffer()
+{
+    return at(m_readPosition);
+}
+
+UInt8* RingNetBuffer::getReadableSpan(UInt32 &size)
+{
+    const UInt32 offset = m_readPosition & (m_size - 1);
+
+    size = m_writePosition - m_readPosition;
+    if (!m_mirrored)
+        size = std::min(size, m_size - offset);
+
+    return m_array + offset;
+}
+
+UInt8* RingNetBuffer::getWritableSpan(UInt32 &size)
+{
+    const UInt32 offset = m_writePosition & (m_size - 1);
+
+    size = m_size - (m_writePosition - m_readPosition);
+    if (!m_mirrored)
+        size = std::min(size, m_size - offset);
+
+    return m_array + offset;
+}
+
+UInt32 RingNetBuffer::getReadableSegments(NetBufferSegment *segments, UInt32 max)
+{
+    const UInt32 available = m_writePosition - m_readPosition;
+    if ((max == 0) || (available == 0))
+        return 0;
+
+    segments[0].data = getReadableSpan(segments[0].size);
+
+    // wrapped around the end of the ring
+    if ((segments[0].size < available) && (max > 1))
+    {
+        segments[1].data = m_array;
+        segments[1].size = available - segments[0].size;
+        return 2;
+    }
+
+    return 1;
+}
+
+UInt32 RingNetBuffer::getWritableSegments(NetBufferSegment *segments, UInt32 max)
+{
+    const UInt32 free = m_size - (m_writePosition - m_readPosition);
+    if ((max == 0) || (free == 0))
+        return 0;
+
+    segments[0].data = getWritableSpan(segments[0].size);
+
+    // wrapped around the end of the ring
+    if ((segments[0].size < free) && (max > 1))
+    {
+        segments[1].data = m_array;
+        segments[1].size = free - segments[0].size;
+        return 2;
+    }
+
+    return 1;
+}
+
+void RingNetBuffer::skip(UInt32 size)
+{
+    if (size > m_writePosition - m_readPosition)
+    {
+        O3D_ERROR(E_BufferOverflow("Read overflow"));
+    }
+    else
+    {
+        m_readPosition += size;
+    }
+}
+
+void RingNetBuffer::extend(UInt32 size)
+{
+    if (size > m_size - (m_writePosition - m_readPosition))
+    {
+        O3D_ERROR(E_BufferOverflow("Write overflow"));
+    }
+    else
+    {
+        m_writePosition += size;
+    }
+}
+
+void RingNetBuffer::compact()
+{
+    // keep the counters small, physical offsets are unchanged
+    const UInt32 base = m_readPosition & ~(m_size - 1);
+
+    m_readPosition -= base;
+    m_writePosition -= base;
+}
+
+void RingNetBuffer::flip()
+{
+    // oldest data still present in the ring
+    m_readPosition = m_writePosition > m_size ? m_writePosition - m_size : 0;
+}
+
+void RingNetBuffer::setByteOrder(System::ByteOrder order)
+{
+    m_byteOrder = order;
+    m_swap = m_byteOrder != System::getNativeByteOrder();
+}
+
+System::ByteOrder RingNetBuffer::getByteOrder() const
+{
+    return m_byteOrder;
+}
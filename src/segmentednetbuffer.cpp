@@ -0,0 +1,743 @@
+/**
+ * @file segmentednetbuffer.cpp
+ * @brief Growable buffer made of a chain of pooled fixed-size segments.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-16
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/net/precompiled.h"
+
+#include "o3d/net/segmentednetbuffer.h"
+#include "o3d/net/netbufferarena.h"
+#include <o3d/core/debug.h>
+
+#include <algorithm>
+
+using namespace o3d;
+using namespace o3d::net;
+
+//
+// NetBufferSegmentPool
+//
+
+namespace {
+
+//! Per thread cache of segments, owned by a single pool at a time.
+struct ThreadSegmentCache
+{
+    UInt32 poolId;
+    UInt32 count;
+    Bool arena;     //!< segments are blocks of an arena
+    UInt8 *segments[NetBufferSegmentPool::THREAD_CACHE_SIZE];
+
+    ~ThreadSegmentCache()
+    {
+        // the pool may be gone, segments are plain arrays, or blocks of an arena
+        // that are freed with its chunks
+        if (!arena)
+        {
+            for (UInt32 i = 0; i < count; ++i)
+            {
+                deleteArray(segments[i]);
+            }
+        }
+    }
+};
+
+thread_local ThreadSegmentCache t_segmentCache = { 0, 0, False, { nullptr } };
+
+std::atomic<UInt32> ms_nextPoolId(1);
+std::atomic<NetBufferSegmentPool*> ms_defaultPool(nullptr);
+
+} // anonymous namespace
+
+NetBufferSegmentPool::NetBufferSegmentPool(UInt32 segmentSize, UInt32 maxFree, NetBufferArena *arena) :
+    m_id(ms_nextPoolId++),
+    m_segmentSize(segmentSize),
+    m_maxFree(maxFree),
+    m_arena(arena),
+    m_numInUse(0),
+    m_peakInUse(0),
+    m_numAcquires(0),
+    m_numAllocations(0)
+{
+    if ((segmentSize == 0) || ((segmentSize & (segmentSize - 1)) != 0))
+        O3D_ERROR(E_InvalidParameter("Segment size must be a power of two"));
+
+    if (arena && (arena->getBlockSize() != segmentSize))
+        O3D_ERROR(E_InvalidParameter("Arena block size must be the segment size"));
+}
+
+NetBufferSegmentPool::~NetBufferSegmentPool()
+{
+    for (UInt8 *segment : m_free)
+    {
+        deallocate(segment);
+    }
+
+    // and the cache of the destroying thread
+    ThreadSegmentCache &cache = t_segmentCache;
+    if (cache.poolId == m_id)
+    {
+        for (UInt32 i = 0; i < cache.count; ++i)
+        {
+            deallocate(cache.segments[i]);
+        }
+
+        cache.count = 0;
+        cache.poolId = 0;
+    }
+}
+
+UInt8* NetBufferSegmentPool::acquire()
+{
+    acquired();
+
+    // thread cache, without lock
+    ThreadSegmentCache &cache = t_segmentCache;
+    if ((cache.poolId == m_id) && (cache.count > 0))
+    {
+        return cache.segments[--cache.count];
+    }
+
+    m_mutex.lock();
+
+    if (!m_free.empty())
+    {
+        UInt8 *segment = m_free.back();
+        m_free.pop_back();
+
+        m_mutex.unlock();
+        return segment;
+    }
+
+    m_mutex.unlock();
+
+    ++m_numAllocations;
+    return allocate();
+}
+
+void NetBufferSegmentPool::release(UInt8 *segment)
+{
+    --m_numInUse;
+
+    // the cache is taken by the pool when empty
+    ThreadSegmentCache &cache = t_segmentCache;
+    if (cache.count == 0)
+    {
+        cache.poolId = m_id;
+        cache.arena = m_arena != nullptr;
+    }
+
+    if ((cache.poolId == m_id) && (cache.count < THREAD_CACHE_SIZE))
+    {
+        cache.segments[cache.count++] = segment;
+        return;
+    }
+
+    m_mutex.lock();
+
+    if (m_free.size() < m_maxFree)
+    {
+        m_free.push_back(segment);
+        segment = nullptr;
+    }
+
+    m_mutex.unlock();
+
+    if (segment)
+        deallocate(segment);
+}
+
+UInt32 NetBufferSegmentPool::getNumFree() const
+{
+    FastMutexLocker locker(m_mutex);
+    return (UInt32)m_free.size();
+}
+
+NetBufferSegmentPool::Stats NetBufferSegmentPool::getStats() const
+{
+    Stats stats;
+
+    stats.numInUse = m_numInUse;
+    stats.peakInUse = m_peakInUse;
+    stats.numFree = getNumFree();
+    stats.numAcquires = m_numAcquires;
+    stats.numAllocations = m_numAllocations;
+
+    return stats;
+}
+
+void NetBufferSegmentPool::acquired()
+{
+    ++m_numAcquires;
+
+    const UInt32 inUse = ++m_numInUse;
+    UInt32 peak = m_peakInUse;
+
+    while ((inUse > peak) && !m_peakInUse.compare_exchange_weak(peak, inUse))
+    {
+    }
+}
+
+UInt8* NetBufferSegmentPool::allocate()
+{
+    if (m_arena)
+        return m_arena->acquire();
+    else
+        return new UInt8[m_segmentSize];
+}
+
+void NetBufferSegmentPool::deallocate(UInt8 *segment)
+{
+    if (m_arena)
+        m_arena->release(segment);
+    else
+        deleteArray(segment);
+}
+
+NetBufferSegmentPool* NetBufferSegmentPool::getDefault()
+{
+    NetBufferSegmentPool *defaultPool = ms_defaultPool;
+    if (defaultPool)
+        return defaultPool;
+
+    static NetBufferSegmentPool pool;
+    return &pool;
+}
+
+void NetBufferSegmentPool::setDefault(NetBufferSegmentPool *pool)
+{
+    ms_defaultPool = pool;
+}
+
+//
+// SegmentedNetBuffer
+//
+
+SegmentedNetBuffer::SegmentedNetBuffer(NetBufferSegmentPool *pool, UInt32 maxSize) :
+    m_pool(pool != nullptr ? pool : NetBufferSegmentPool::getDefault()),
+    m_segmentShift(0),
+    m_maxSize(maxSize),
+    m_readPosition(0),
+    m_writePosition(0)
+{
+    m_segmentSize = m_pool->getSegmentSize();
+    while ((1U << m_segmentShift) < m_segmentSize)
+    {
+        ++m_segmentShift;
+    }
+
+    // positions are returned as Int32
+    if (m_maxSize > 0x7FFFFFFF)
+        m_maxSize = 0x7FFFFFFF;
+
+    setByteOrder(System::getNativeByteOrder());
+}
+
+SegmentedNetBuffer::~SegmentedNetBuffer()
+{
+    for (UInt8 *segment : m_segments)
+    {
+        m_pool->release(segment);
+    }
+}
+
+void SegmentedNetBuffer::grow(UInt32 size)
+{
+    if (size > m_maxSize - (m_writePosition - m_readPosition))
+        O3D_ERROR(E_BufferOverflow("Write overflow"));
+
+    const UInt32 capacity = (UInt32)m_segments.size() << m_segmentShift;
+    if (size > capacity - m_writePosition)
+    {
+        UInt32 count = (m_writePosition + size - capacity + m_segmentSize - 1) >> m_segmentShift;
+        while (count--)
+        {
+            m_segments.push_back(m_pool->acquire());
+        }
+    }
+}
+
+void SegmentedNetBuffer::writeBytes(const UInt8 *data, UInt32 size)
+{
+    grow(size);
+
+    while (size > 0)
+    {
+        const UInt32 offset = m_writePosition & (m_segmentSize - 1);
+        const UInt32 len = std::min(size, m_segmentSize - offset);
+
+        memcpy(m_segments[m_writePosition >> m_segmentShift] + offset, data, len);
+
+        m_writePosition += len;
+        data += len;
+        size -= len;
+    }
+}
+
+void SegmentedNetBuffer::readBytes(UInt8 *data, UInt32 size)
+{
+    if (size > m_writePosition - m_readPosition)
+        O3D_ERROR(E_BufferOverflow("Read overflow"));
+
+    while (size > 0)
+    {
+        const UInt32 offset = m_readPosition & (m_segmentSize - 1);
+        const UInt32 len = std::min(size, m_segmentSize - offset);
+
+        memcpy(data, m_segments[m_readPosition >> m_segmentShift] + offset, len);
+
+        m_readPosition += len;
+        data += len;
+        size -= len;
+    }
+}
+
+void SegmentedNetBuffer::writeSwapped(const UInt8 *value, UInt32 size)
+{
+    if (m_swap)
+    {
+        UInt8 swapped[8];
+        for (UInt32 i = 0; i < size; ++i)
+        {
+            swapped[i] = value[size - 1 - i];
+        }
+
+        writeBytes(swapped, size);
+    }
+    else
+        writeBytes(value, size);
+}
+
+void SegmentedNetBuffer::readSwapped(UInt8 *value, UInt32 size)
+{
+    if (m_swap)
+    {
+        UInt8 swapped[8];
+        readBytes(swapped, size);
+
+        for (UInt32 i = 0; i < size; ++i)
+        {
+            value[i] = swapped[size - 1 - i];
+        }
+    }
+    else
+        readBytes(value, size);
+}
+
+void SegmentedNetBuffer::writeInt8(Int8 value)
+{
+    writeBytes(reinterpret_cast<const UInt8*>(&value), 1);
+}
+
+void SegmentedNetBuffer::writeUInt8(UInt8 value)
+{
+    writeBytes(&value, 1);
+}
+
+void SegmentedNetBuffer::writeInt16(Int16 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 2);
+}
+
+void SegmentedNetBuffer::writeUInt16(UInt16 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 2);
+}
+
+void SegmentedNetBuffer::writeInt32(Int32 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 4);
+}
+
+void SegmentedNetBuffer::writeUInt32(UInt32 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 4);
+}
+
+void SegmentedNetBuffer::writeInt64(Int64 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 8);
+}
+
+void SegmentedNetBuffer::writeUInt64(UInt64 value)
+{
+    writeSwapped(reinterpret_cast<const UInt8*>(&value), 8);
+}
+
+void SegmentedNetBuffer::writeUTF8(const String &string)
+{
+    CString utf8 = string.toUtf8();
+
+    writeInt16((Int16)utf8.length());
+    writeBytes(reinterpret_cast<const UInt8*>(utf8.getData()), utf8.length());
+}
+
+void SegmentedNetBuffer::writeUTF8(const Char *string)
+{
+    UInt32 length = (UInt32)strlen(string);
+
+    writeInt16((Int16)length);
+    writeBytes(reinterpret_cast<const UInt8*>(string), length);
+}
+
+void SegmentedNetBuffer::writeBool(Bool value)
+{
+    writeUInt8(value ? 1 : 0);
+}
+
+void SegmentedNetBuffer::write(const UInt8 *buffer, UInt32 size)
+{
+    writeBytes(buffer, size);
+}
+
+Int8 SegmentedNetBuffer::readInt8()
+{
+    Int8 value;
+    readBytes(reinterpret_cast<UInt8*>(&value), 1);
+    return value;
+}
+
+UInt8 SegmentedNetBuffer::readUInt8()
+{
+    UInt8 value;
+    readBytes(&value, 1);
+    return value;
+}
+
+Int16 SegmentedNetBuffer::readInt16()
+{
+    Int16 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 2);
+    return value;
+}
+
+UInt16 SegmentedNetBuffer::readUInt16()
+{
+    UInt16 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 2);
+    return value;
+}
+
+Int32 SegmentedNetBuffer::readInt32()
+{
+    Int32 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 4);
+    return value;
+}
+
+UInt32 SegmentedNetBuffer::readUInt32()
+{
+    UInt32 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 4);
+    return value;
+}
+
+Int64 SegmentedNetBuffer::readInt64()
+{
+    Int64 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 8);
+    return value;
+}
+
+UInt64 SegmentedNetBuffer::readUInt64()
+{
+    UInt64 value;
+    readSwapped(reinterpret_cast<UInt8*>(&value), 8);
+    return value;
+}
+
+Bool SegmentedNetBuffer::read(UInt8 *buffer, Int16 size)
+{
+    if ((size >= 0) && (getAvailable() >= size))
+    {
+        readBytes(buffer, size);
+        return True;
+    }
+    return False;
+}
+
+Bool SegmentedNetBuffer::readUTF8(Char *string, Int16 size)
+{
+    if ((size >= 0) && (getAvailable() >= size))
+    {
+        readBytes(reinterpret_cast<UInt8*>(string), size);
+        string[size] = 0x00;
+        return True;
+    }
+    return False;
+}
+
+Bool SegmentedNetBuffer::readUTF8(String &string)
+{
+    if (getAvailable() >= 2)
+    {
+        Int16 size = readInt16();
+        if ((getAvailable() >= size) && (size > 0))
+        {
+            const UInt32 offset = m_readPosition & (m_segmentSize - 1);
+
+            // contiguous, no need of a temporary copy
+            if (offset + size <= m_segmentSize)
+            {
+                string.fromUtf8(reinterpret_cast<Char*>(
+                                    m_segments[m_readPosition >> m_segmentShift] + offset), size);
+                m_readPosition += size;
+            }
+            else
+            {
+                std::vector<Char> utf8(size);
+                readBytes(reinterpret_cast<UInt8*>(utf8.data()), size);
+                string.fromUtf8(utf8.data(), size);
+            }
+        }
+        else
+        {
+            string << "";
+        }
+        return True;
+    }
+    return False;
+}
+
+Bool SegmentedNetBuffer::readBool()
+{
+    return readUInt8() != 0 ? True : False;
+}
+
+Int32 SegmentedNetBuffer::getAvailable() const
+{
+    return m_writePosition - m_readPosition;
+}
+
+Int32 SegmentedNetBuffer::getFree() const
+{
+    return m_maxSize - (m_writePosition - m_readPosition);
+}
+
+void SegmentedNetBuffer::patch(UInt32 handle, const UInt8 *data, UInt32 size)
+{
+    if ((handle > m_writePosition) || (size > m_writePosition - handle))
+        O3D_ERROR(E_BufferOverflow("Patch overflow"));
+
+    while (size > 0)
+    {
+        const UInt32 offset = handle & (m_segmentSize - 1);
+        const UInt32 len = std::min(size, m_segmentSize - offset);
+
+        memcpy(m_segments[handle >> m_segmentShift] + offset, data, len);
+
+        handle += len;
+        data += len;
+        size -= len;
+    }
+}
+
+UInt32 SegmentedNetBuffer::getLimit() const
+{
+    return m_writePosition;
+}
+
+void SegmentedNetBuffer::setLimit(UInt32 limit)
+{
+    if ((limit < m_readPosition) || (limit > ((UInt32)m_segments.size() << m_segmentShift)))
+    {
+        O3D_ERROR(E_BufferOverflow("Limit overflow"));
+    }
+    else
+    {
+        m_writePosition = limit;
+    }
+}
+
+UInt32 SegmentedNetBuffer::getPosition() const
+{
+    return m_readPosition;
+}
+
+void SegmentedNetBuffer::setPosition(UInt32 position)
+{
+    if (position > m_writePosition)
+    {
+        O3D_ERROR(E_BufferOverflow("Position overflow"));
+    }
+    else
+    {
+        m_readPosition = position;
+    }
+}
+
+UInt8* SegmentedNetBuffer::getWriteBuffer()
+{
+    UInt32 size;
+    return getWritableSpan(size);
+}
+
+UInt8* SegmentedNetBuffer::getBuffer()
+{
+    return m_segments.empty() ? nullptr : m_segments.front();
+}
+
+UInt8* SegmentedNetBuffer::getReadableSpan(UInt32 &size)
+{
+    const UInt32 available = m_writePosition - m_readPosition;
+    if (available == 0)
+    {
+        size = 0;
+        return nullptr;
+    }
+
+    const UInt32 offset = m_readPosition & (m_segmentSize - 1);
+    size = std::min(available, m_segmentSize - offset);
+
+    return m_segments[m_readPosition >> m_segmentShift] + offset;
+}
+
+UInt8* SegmentedNetBuffer::getWritableSpan(UInt32 &size)
+{
+    const UInt32 free = m_maxSize - (m_writePosition - m_readPosition);
+    if (free == 0)
+    {
+        size = 0;
+        return nullptr;
+    }
+
+    // current segment is full, get a new one
+    if (m_writePosition == ((UInt32)m_segments.size() << m_segmentShift))
+        m_segments.push_back(m_pool->acquire());
+
+    const UInt32 offset = m_writePosition & (m_segmentSize - 1);
+    size = std::min(free, m_segmentSize - offset);
+
+    return m_segments[m_writePosition >> m_segmentShift] + offset;
+}
+
+UInt32 SegmentedNetBuffer::getReadableSegments(NetBufferSegment *segments, UInt32 max)
+{
+    UInt32 position = m_readPosition;
+    UInt32 count = 0;
+
+    while ((count < max) && (position < m_writePosition))
+    {
+        const UInt32 offset = position & (m_segmentSize - 1);
+        const UInt32 size = std::min(m_writePosition - position, m_segmentSize - offset);
+
+        segments[count].data = m_segments[position >> m_segmentShift] + offset;
+        segments[count].size = size;
+
+        position += size;
+        ++count;
+    }
+
+    return count;
+}
+
+UInt32 SegmentedNetBuffer::getWritableSegments(NetBufferSegment *segments, UInt32 max)
+{
+    const UInt32 end = m_readPosition + m_maxSize;
+    UInt32 position = m_writePosition;
+    UInt32 count = 0;
+
+    while ((count < max) && (position < end))
+    {
+        // acquire the missing segments, given back at the next drained compact
+        if (position == ((UInt32)m_segments.size() << m_segmentShift))
+            m_segments.push_back(m_pool->acquire());
+
+        const UInt32 offset = position & (m_segmentSize - 1);
+        const UInt32 size = std::min(end - position, m_segmentSize - offset);
+
+        segments[count].data = m_segments[position >> m_segmentShift] + offset;
+        segments[count].size = size;
+
+        position += size;
+        ++count;
+    }
+
+    return count;
+}
+
+void SegmentedNetBuffer::skip(UInt32 size)
+{
+    if (size > m_writePosition - m_readPosition)
+    {
+        O3D_ERROR(E_BufferOverflow("Read overflow"));
+    }
+    else
+    {
+        m_readPosition += size;
+    }
+}
+
+void SegmentedNetBuffer::extend(UInt32 size)
+{
+    if (size > ((UInt32)m_segments.size() << m_segmentShift) - m_writePosition)
+    {
+        O3D_ERROR(E_BufferOverflow("Write overflow"));
+    }
+    else
+    {
+        m_writePosition += size;
+    }
+}
+
+void SegmentedNetBuffer::compact()
+{
+    if (m_readPosition == m_writePosition)
+    {
+        // fully drained, idle buffer does not hold any segment
+        for (UInt8 *segment : m_segments)
+        {
+            m_pool->release(segment);
+        }
+
+        m_segments.clear();
+
+        m_readPosition = 0;
+        m_writePosition = 0;
+
+        return;
+    }
+
+    // release the segments fully read
+    const UInt32 drained = m_readPosition >> m_segmentShift;
+    if (drained > 0)
+    {
+        for (UInt32 i = 0; i < drained; ++i)
+        {
+            m_pool->release(m_segments[i]);
+        }
+
+        m_segments.erase(m_segments.begin(), m_segments.begin() + drained);
+
+        m_readPosition -= drained << m_segmentShift;
+        m_writePosition -= drained << m_segmentShift;
+    }
+
+    // and the unused ones after the write position
+    const UInt32 used = (m_writePosition + m_segmentSize - 1) >> m_segmentShift;
+    while (m_segments.size() > used)
+    {
+        m_pool->release(m_segments.back());
+        m_segments.pop_back();
+    }
+}
+
+void SegmentedNetBuffer::flip()
+{
+    m_readPosition = 0;
+}
+
+void SegmentedNetBuffer::setByteOrder(System::ByteOrder order)
+{
+    m_byteOrder = order;
+    m_swap = m_byteOrder != System::getNativeByteOrder();
+}
+
+System::ByteOrder SegmentedNetBuffer::getByteOrder() const
+{
+    return m_byteOrder;
+}
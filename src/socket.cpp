@@ -19,6 +19,12 @@
 using namespace o3d;
 using namespace o3d::net;
 
+// maximum number of regions of a scatter/gather call
+static const UInt32 MAX_IO_SEGMENTS = 16;
+
+// bounds the segments a growable buffer acquires ahead of a receive
+static const UInt32 MAX_RECEIVE_SEGMENTS = 4;
+
 // POSIX socket initialization, nothing to do at all
 #ifndef O3D_WIN_SOCKET
 
@@ -296,20 +302,71 @@ Int32 Socket::send(const UInt8* pData, Int32 len, Int32 option)
 	return SOCKET_ERROR;
 }
 
+//---------------------------------------------------------------------------------------
+// send several regions at once
+//---------------------------------------------------------------------------------------
+Int32 Socket::send(const NetBufferSegment *segments, UInt32 count, Int32 option)
+{
+	if (m_socket_id != O3D_INVALID_SOCKET)
+	{
+		if (count > MAX_IO_SEGMENTS)
+			count = MAX_IO_SEGMENTS;
+
+#ifdef O3D_WIN_SOCKET
+		WSABUF buffers[MAX_IO_SEGMENTS];
+		for (UInt32 i = 0; i < count; ++i)
+		{
+			buffers[i].buf = (CHAR*)segments[i].data;
+			buffers[i].len = segments[i].size;
+		}
+
+		DWORD size = 0;
+		if (::WSASend(m_socket_id, buffers, count, &size, option, nullptr, nullptr) == SOCKET_ERROR)
+			return SOCKET_ERROR;
+
+		return (Int32)size;
+#else
+		struct iovec buffers[MAX_IO_SEGMENTS];
+		for (UInt32 i = 0; i < count; ++i)
+		{
+			buffers[i].iov_base = segments[i].data;
+			buffers[i].iov_len = segments[i].size;
+		}
+
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = buffers;
+		msg.msg_iovlen = count;
+
+		Int32 size;
+		if ((size = (Int32)::sendmsg(m_socket_id, &msg, option)) == SOCKET_ERROR)
+			return SOCKET_ERROR;
+
+		return size;
+#endif
+	}
+	return SOCKET_ERROR;
+}
+
 //---------------------------------------------------------------------------------------
 // send Data from buffer
 //---------------------------------------------------------------------------------------
 Int32 Socket::sendFromBuffer(NetBuffer* buffer, Int32 option)
 {
-	Int32 result = send(
-			reinterpret_cast<UInt8*>(buffer->getBuffer()),
-			buffer->getAvailable(),
-			option);
+	NetBufferSegment segments[MAX_IO_SEGMENTS];
+	UInt32 count = buffer->getReadableSegments(segments, MAX_IO_SEGMENTS);
+
+	if (count == 0)
+		return 0;
+
+	Int32 result = count == 1 ?
+				send(segments[0].data, segments[0].size, option) :
+				send(segments, count, option);
 
 	if (result >= 0)
 	{
         //O3D_MESSAGE(String("SendFromBuffer ") << result);
-		buffer->setPosition(result);
+		buffer->skip(result);
 		return result;
 	}
 
@@ -335,21 +392,75 @@ Int32 Socket::receive(UInt8* pData, Int32 len, Int32 option)
 	return SOCKET_ERROR;
 }
 
+//---------------------------------------------------------------------------------------
+// receive into several regions at once
+//---------------------------------------------------------------------------------------
+Int32 Socket::receive(const NetBufferSegment *segments, UInt32 count, Int32 option)
+{
+	if (m_socket_id != O3D_INVALID_SOCKET)
+	{
+		if (count > MAX_IO_SEGMENTS)
+			count = MAX_IO_SEGMENTS;
+
+#ifdef O3D_WIN_SOCKET
+		WSABUF buffers[MAX_IO_SEGMENTS];
+		for (UInt32 i = 0; i < count; ++i)
+		{
+			buffers[i].buf = (CHAR*)segments[i].data;
+			buffers[i].len = segments[i].size;
+		}
+
+		DWORD size = 0;
+		DWORD flags = option;
+		if (::WSARecv(m_socket_id, buffers, count, &size, &flags, nullptr, nullptr) == SOCKET_ERROR)
+			return SOCKET_ERROR;
+
+		return (Int32)size;
+#else
+		struct iovec buffers[MAX_IO_SEGMENTS];
+		for (UInt32 i = 0; i < count; ++i)
+		{
+			buffers[i].iov_base = segments[i].data;
+			buffers[i].iov_len = segments[i].size;
+		}
+
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = buffers;
+		msg.msg_iovlen = count;
+
+		Int32 size;
+		if ((size = (Int32)::recvmsg(m_socket_id, &msg, option)) == SOCKET_ERROR)
+			return SOCKET_ERROR;
+
+		return size;
+#endif
+	}
+
+	return SOCKET_ERROR;
+}
+
 //---------------------------------------------------------------------------------------
 // Read data and store them into buffer
 //---------------------------------------------------------------------------------------
 Int32 Socket::receiveIntoBuffer(NetBuffer* buffer, Int32 option)
 {
-	Int32 result = receive(
-		reinterpret_cast<UInt8*>(buffer->getWriteBuffer()),
-		buffer->getFree(),
-		option);
+	NetBufferSegment segments[MAX_IO_SEGMENTS];
+	UInt32 count = buffer->getWritableSegments(segments, MAX_RECEIVE_SEGMENTS);
+
+	// buffer is full, let the reader consume it before
+	if (count == 0)
+		return 0;
+
+	Int32 result = count == 1 ?
+				receive(segments[0].data, segments[0].size, option) :
+				receive(segments, count, option);
 
 	if (result >= 0)
 	{
 		if (result > 0)
 		{
-			buffer->setLimit(buffer->getLimit() + result);
+			buffer->extend(result);
 			return result;
 		}
 
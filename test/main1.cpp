@@ -153,6 +153,10 @@ public:
 
 	virtual NetMessage* buildFromBuffer(NetBuffer* buffer)
 	{
+		// wait for the whole header
+		if (!buffer->ensureReadable(3))
+			return NULL;
+
         Int32 messageType = buffer->readInt8();
 		NetMessage* message = NULL;
 
@@ -247,7 +251,7 @@ public:
 			{
 				message->run(NULL);
 				message->consume();
-				deletePtr(message);
+				message->release();
 			}
             System::waitMs(100);
 		}